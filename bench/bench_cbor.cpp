@@ -0,0 +1,132 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+//
+// Compare CBOR and JSON text encodings of the same UniValue trees:
+// encoded size, and encode/decode throughput.
+//
+// $ bench/bench_cbor [file.json ...]
+//
+
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "univalue.h"
+
+#ifndef JSON_TEST_SRC
+#error JSON_TEST_SRC must point to test source directory
+#endif
+
+static const double MIN_BENCH_SECONDS = 0.2;
+
+static bool readFile(const std::string& filename, std::string& data)
+{
+    FILE *f = fopen(filename.c_str(), "rb");
+    if (!f)
+        return false;
+
+    char buf[4096];
+    size_t bread;
+    while ((bread = fread(buf, 1, sizeof(buf), f)) > 0)
+        data.append(buf, bread);
+    fclose(f);
+    return true;
+}
+
+// A block-shaped document: mostly hex strings, integers and amounts
+static UniValue makeBlock(int nTx)
+{
+    UniValue block(UniValue::VOBJ);
+    block.pushKV("hash", std::string(64, 'a'));
+    block.pushKV("height", 840000);
+    block.pushKV("time", (int64_t)1713571767);
+    block.pushKV("difficulty", 86388558925171.02);
+
+    UniValue txs(UniValue::VARR);
+    for (int i = 0; i < nTx; i++) {
+        UniValue tx(UniValue::VOBJ);
+        tx.pushKV("txid", std::string(64, 'b'));
+        tx.pushKV("size", 200 + i % 300);
+        UniValue vout(UniValue::VARR);
+        for (int n = 0; n < 2; n++) {
+            UniValue out(UniValue::VOBJ);
+            UniValue value;
+            value.setNumStr("0.00012345");
+            out.pushKV("value", value);
+            out.pushKV("n", n);
+            out.pushKV("hex", std::string(44, 'c'));
+            vout.push_back(out);
+        }
+        tx.pushKV("vout", vout);
+        txs.push_back(tx);
+    }
+    block.pushKV("tx", txs);
+    return block;
+}
+
+// Run fn repeatedly for at least MIN_BENCH_SECONDS, return seconds per run
+template <typename F>
+static double timeIt(F fn)
+{
+    typedef std::chrono::steady_clock clock;
+    unsigned long runs = 0;
+    clock::time_point start = clock::now();
+    double elapsed;
+    do {
+        fn();
+        runs++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < MIN_BENCH_SECONDS);
+    return elapsed / runs;
+}
+
+static void bench(const std::string& name, const UniValue& val)
+{
+    std::string json = val.write();
+    std::string cbor = val.writeCBOR();
+
+    double jsonEnc = timeIt([&]() { val.write(); });
+    double cborEnc = timeIt([&]() { val.writeCBOR(); });
+    UniValue tmp;
+    double jsonDec = timeIt([&]() { tmp.read(json); });
+    double cborDec = timeIt([&]() { tmp.readCBOR(cbor); });
+
+    double mb = json.size() / 1e6;
+    printf("%-20s %10zu %10zu %6.1f%% %9.1f %9.1f %9.1f %9.1f\n",
+           name.c_str(), json.size(), cbor.size(), 100.0 * cbor.size() / json.size(),
+           mb / jsonEnc, mb / cborEnc, mb / jsonDec, mb / cborDec);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        files.push_back(std::string(JSON_TEST_SRC) + "/pass1.json");
+        files.push_back(std::string(JSON_TEST_SRC) + "/round1.json");
+        files.push_back(std::string(JSON_TEST_SRC) + "/round2.json");
+    }
+
+    // throughput is in MB of JSON text per second for both encodings
+    printf("%-20s %10s %10s %7s %9s %9s %9s %9s\n", "document", "json", "cbor",
+           "ratio", "write", "writeCBOR", "read", "readCBOR");
+
+    for (size_t i = 0; i < files.size(); i++) {
+        std::string data;
+        UniValue val;
+        if (!readFile(files[i], data) || !val.read(data)) {
+            fprintf(stderr, "%s: cannot read JSON\n", files[i].c_str());
+            return 1;
+        }
+        std::string name = files[i].substr(files[i].find_last_of('/') + 1);
+        bench(name, val);
+    }
+
+    bench("block-100tx", makeBlock(100));
+    bench("block-3000tx", makeBlock(3000));
+
+    return 0;
+}
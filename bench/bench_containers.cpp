@@ -0,0 +1,209 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+//
+// Allocations and time spent on the many small arrays and objects of
+// block and transaction JSON.  Each document is read three ways:
+//
+//   grown   the tree rebuilt one push_back()/pushKV() at a time, which is
+//           how the parser used to fill containers
+//   read    UniValue::read(), which presizes small containers
+//   exact   UniValueReader in exact-capacity mode
+//
+// and each resulting tree is then traversed, to show the effect of the
+// layout on later use.
+//
+// $ bench/bench_containers
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include "univalue.h"
+#include "univalue_reader.h"
+
+static const double MIN_BENCH_SECONDS = 0.2;
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static UniValue hexStr(size_t len, char c)
+{
+    return UniValue(std::string(len, c));
+}
+
+static UniValue amount(const char *text)
+{
+    UniValue v;
+    v.setNumStr(text);
+    return v;
+}
+
+// A verbose getrawtransaction result: one or two inputs, two outputs
+static UniValue makeTx(int i)
+{
+    UniValue tx(UniValue::VOBJ);
+    tx.pushKV("txid", hexStr(64, 'a'));
+    tx.pushKV("hash", hexStr(64, 'b'));
+    tx.pushKV("version", 2);
+    tx.pushKV("size", 222 + i % 100);
+    tx.pushKV("vsize", 141 + i % 50);
+    tx.pushKV("locktime", 0);
+
+    UniValue vin(UniValue::VARR);
+    for (int n = 0; n < 1 + i % 2; n++) {
+        UniValue in(UniValue::VOBJ);
+        in.pushKV("txid", hexStr(64, 'c'));
+        in.pushKV("vout", n);
+        UniValue sig(UniValue::VOBJ);
+        sig.pushKV("asm", "");
+        sig.pushKV("hex", "");
+        in.pushKV("scriptSig", sig);
+        UniValue witness(UniValue::VARR);
+        witness.push_back(hexStr(142, 'd'));
+        witness.push_back(hexStr(66, 'e'));
+        in.pushKV("txinwitness", witness);
+        in.pushKV("sequence", (int64_t)4294967293LL);
+        vin.push_back(in);
+    }
+    tx.pushKV("vin", vin);
+
+    UniValue vout(UniValue::VARR);
+    for (int n = 0; n < 2; n++) {
+        UniValue out(UniValue::VOBJ);
+        out.pushKV("value", amount(n ? "0.01000000" : "0.00054321"));
+        out.pushKV("n", n);
+        UniValue spk(UniValue::VOBJ);
+        spk.pushKV("asm", "0 " + std::string(40, 'f'));
+        spk.pushKV("desc", "addr(bc1q" + std::string(38, 'g') + ")#abcdefgh");
+        spk.pushKV("hex", "0014" + std::string(40, 'f'));
+        spk.pushKV("address", "bc1q" + std::string(38, 'g'));
+        spk.pushKV("type", "witness_v0_keyhash");
+        out.pushKV("scriptPubKey", spk);
+        vout.push_back(out);
+    }
+    tx.pushKV("vout", vout);
+    return tx;
+}
+
+static UniValue makeBlock(int nTx)
+{
+    UniValue block(UniValue::VOBJ);
+    block.pushKV("hash", hexStr(64, '0'));
+    block.pushKV("confirmations", 1);
+    block.pushKV("height", 840000);
+    block.pushKV("time", (int64_t)1713571767);
+    block.pushKV("difficulty", 86388558925171.02);
+    UniValue txs(UniValue::VARR);
+    for (int i = 0; i < nTx; i++)
+        txs.push_back(makeTx(i));
+    block.pushKV("tx", txs);
+    return block;
+}
+
+// Copy val by pushing one child at a time into fresh containers
+static UniValue grow(const UniValue& val)
+{
+    if (val.isArray()) {
+        UniValue arr(UniValue::VARR);
+        for (size_t i = 0; i < val.size(); i++)
+            arr.push_back(grow(val[i]));
+        return arr;
+    }
+    if (val.isObject()) {
+        UniValue obj(UniValue::VOBJ);
+        for (size_t i = 0; i < val.size(); i++)
+            obj.__pushKV(val.getKeys()[i], grow(val[i]));
+        return obj;
+    }
+    return val;
+}
+
+static size_t traverse(const UniValue& val)
+{
+    size_t n = val.getValStr().size();
+    for (size_t i = 0; i < val.size(); i++)
+        n += traverse(val[i]);
+    return n;
+}
+
+// Run fn repeatedly for at least MIN_BENCH_SECONDS; return nanoseconds
+// and allocations per run
+template <typename F>
+static void timeIt(F fn, double& ns, double& allocs)
+{
+    typedef std::chrono::steady_clock clock;
+    unsigned long runs = 0;
+    size_t before = allocations;
+    clock::time_point start = clock::now();
+    double elapsed;
+    do {
+        fn();
+        runs++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < MIN_BENCH_SECONDS);
+    ns = elapsed * 1e9 / runs;
+    allocs = (double)(allocations - before) / runs;
+}
+
+static volatile size_t sink;
+
+static void bench(const char *name, const UniValue& doc)
+{
+    std::string json = doc.write();
+    UniValue tree;
+    UniValueReader reader;
+    reader.setExactCapacity(true);
+
+    double ns, allocs, walk, unused;
+    printf("%-14s %8zu bytes\n", name, json.size());
+
+    UniValue parsed;
+    parsed.read(json);
+    timeIt([&]() { tree = grow(parsed); }, ns, allocs);
+    timeIt([&]() { sink = traverse(tree); }, walk, unused);
+    printf("  %-8s %12.0f %12.1f %12zu %12.0f\n", "grown", ns, allocs,
+           tree.dynamicMemoryUsage(), walk);
+
+    timeIt([&]() { tree = UniValue(); tree.read(json); }, ns, allocs);
+    timeIt([&]() { sink = traverse(tree); }, walk, unused);
+    printf("  %-8s %12.0f %12.1f %12zu %12.0f\n", "read", ns, allocs,
+           tree.dynamicMemoryUsage(), walk);
+
+    timeIt([&]() { reader.read(json, tree); }, ns, allocs);
+    timeIt([&]() { sink = traverse(tree); }, walk, unused);
+    printf("  %-8s %12.0f %12.1f %12zu %12.0f\n", "exact", ns, allocs,
+           tree.dynamicMemoryUsage(), walk);
+}
+
+int main(int argc, char *argv[])
+{
+    printf("%-25s %12s %12s %12s %12s\n", "", "ns/op", "allocs/op", "heap bytes", "walk ns");
+
+    bench("tx", makeTx(1));
+    bench("block-100tx", makeBlock(100));
+    bench("block-3000tx", makeBlock(3000));
+
+    return 0;
+}
@@ -0,0 +1,415 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+//
+// Throughput of the core operations over a fixed corpus: the test suite's
+// valid documents, plus generated block-, mempool- and wallet-shaped
+// documents at several sizes.  For each document:
+//
+//   read          UniValue::read() of the compact text
+//   write         compact write()
+//   write_pretty  write(4)
+//   get           visit every value with the strict getters
+//   find          look up every key of every object by name
+//   build         construct the document with pushKV() (generated only)
+//
+// and "escape" documents exercise write() on strings that are mostly
+// escapes and on strings that have none.
+//
+// Each result is printed as one line of JSON, e.g.
+//
+//   {"bench":"read","doc":"block-100tx","bytes":215327,"ops":1,
+//    "ns_per_op":1234567.8,"mb_per_s":174.4,"allocs_per_op":4213.0}
+//
+// where ops is the number of operations in one run: 1, except for find,
+// which counts each lookup.  mb_per_s, relative to the size of the
+// compact text, is only given for operations on a whole document.
+//
+// $ bench/bench_univalue [filter]
+//
+// runs only the benchmarks whose "bench/doc" name contains filter.  The
+// environment variable UNIVALUE_BENCH_SECONDS sets the minimum time per
+// benchmark (default 0.1).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "univalue.h"
+
+#ifndef JSON_TEST_SRC
+#error JSON_TEST_SRC must point to test source directory
+#endif
+
+static double minBenchSeconds = 0.1;
+static const char *filter = NULL;
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static bool readFile(const std::string& filename, std::string& data)
+{
+    FILE *f = fopen(filename.c_str(), "rb");
+    if (!f)
+        return false;
+
+    char buf[4096];
+    size_t bread;
+    while ((bread = fread(buf, 1, sizeof(buf), f)) > 0)
+        data.append(buf, bread);
+    fclose(f);
+    return true;
+}
+
+// Deterministic pseudo-random numbers, so every run sees the same corpus
+static uint64_t rngState;
+
+static uint32_t rng()
+{
+    rngState = rngState * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(rngState >> 33);
+}
+
+static std::string hex(size_t len)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string s(len, '0');
+    for (size_t i = 0; i < len; i++)
+        s[i] = digits[rng() & 15];
+    return s;
+}
+
+static UniValue amount()
+{
+    char buf[32];
+    uint32_t sats = rng() % 100000000;
+    snprintf(buf, sizeof(buf), "%u.%08u", rng() % 50, sats);
+    UniValue v;
+    v.setNumStr(buf);
+    return v;
+}
+
+static std::string address()
+{
+    return "bc1q" + hex(38);
+}
+
+// A verbose getblock result
+static UniValue makeBlock(int nTx)
+{
+    rngState = 1;
+    UniValue block(UniValue::VOBJ);
+    block.pushKV("hash", hex(64));
+    block.pushKV("confirmations", 1);
+    block.pushKV("height", 840000);
+    block.pushKV("version", 0x20000000);
+    block.pushKV("merkleroot", hex(64));
+    block.pushKV("time", (int64_t)1713571767);
+    block.pushKV("nonce", (int64_t)rng());
+    block.pushKV("bits", "17034219");
+    block.pushKV("difficulty", 86388558925171.02);
+    block.pushKV("previousblockhash", hex(64));
+
+    UniValue txs(UniValue::VARR);
+    for (int i = 0; i < nTx; i++) {
+        UniValue tx(UniValue::VOBJ);
+        tx.pushKV("txid", hex(64));
+        tx.pushKV("hash", hex(64));
+        tx.pushKV("version", 2);
+        tx.pushKV("size", 150 + (int)(rng() % 400));
+        tx.pushKV("weight", 500 + (int)(rng() % 1200));
+        tx.pushKV("locktime", 0);
+
+        UniValue vin(UniValue::VARR);
+        for (int n = 0, nIn = 1 + rng() % 3; n < nIn; n++) {
+            UniValue in(UniValue::VOBJ);
+            in.pushKV("txid", hex(64));
+            in.pushKV("vout", (int)(rng() % 4));
+            UniValue sig(UniValue::VOBJ);
+            sig.pushKV("asm", "");
+            sig.pushKV("hex", "");
+            in.pushKV("scriptSig", sig);
+            UniValue witness(UniValue::VARR);
+            witness.push_back(hex(142));
+            witness.push_back(hex(66));
+            in.pushKV("txinwitness", witness);
+            in.pushKV("sequence", (int64_t)4294967293LL);
+            vin.push_back(in);
+        }
+        tx.pushKV("vin", vin);
+
+        UniValue vout(UniValue::VARR);
+        for (int n = 0, nOut = 1 + rng() % 3; n < nOut; n++) {
+            UniValue out(UniValue::VOBJ);
+            out.pushKV("value", amount());
+            out.pushKV("n", n);
+            UniValue spk(UniValue::VOBJ);
+            std::string program = hex(40);
+            spk.pushKV("asm", "0 " + program);
+            spk.pushKV("desc", "addr(" + address() + ")#" + hex(8));
+            spk.pushKV("hex", "0014" + program);
+            spk.pushKV("address", address());
+            spk.pushKV("type", "witness_v0_keyhash");
+            out.pushKV("scriptPubKey", spk);
+            vout.push_back(out);
+        }
+        tx.pushKV("vout", vout);
+        txs.push_back(tx);
+    }
+    block.pushKV("tx", txs);
+    return block;
+}
+
+// A verbose getrawmempool result: one wide object keyed by txid
+static UniValue makeMempool(int nTx)
+{
+    rngState = 2;
+    UniValue pool(UniValue::VOBJ);
+    for (int i = 0; i < nTx; i++) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("vsize", 110 + (int)(rng() % 500));
+        entry.pushKV("weight", 440 + (int)(rng() % 2000));
+        entry.pushKV("time", (int64_t)1713571767 - (int64_t)(rng() % 86400));
+        entry.pushKV("height", 840000 - (int)(rng() % 100));
+        entry.pushKV("descendantcount", 1 + (int)(rng() % 3));
+        entry.pushKV("descendantsize", 110 + (int)(rng() % 1500));
+        entry.pushKV("ancestorcount", 1 + (int)(rng() % 3));
+        entry.pushKV("ancestorsize", 110 + (int)(rng() % 1500));
+        entry.pushKV("wtxid", hex(64));
+        UniValue fees(UniValue::VOBJ);
+        fees.pushKV("base", amount());
+        fees.pushKV("modified", amount());
+        fees.pushKV("ancestor", amount());
+        fees.pushKV("descendant", amount());
+        entry.pushKV("fees", fees);
+        UniValue depends(UniValue::VARR);
+        for (int n = 0, nDep = rng() % 3; n < nDep; n++)
+            depends.push_back(hex(64));
+        entry.pushKV("depends", depends);
+        entry.pushKV("spentby", UniValue(UniValue::VARR));
+        entry.pushKV("bip125-replaceable", (rng() & 1) != 0);
+        entry.pushKV("unbroadcast", false);
+        pool.pushKV(hex(64), entry);
+    }
+    return pool;
+}
+
+// A listtransactions result
+static UniValue makeWallet(int nTx)
+{
+    rngState = 3;
+    static const char *categories[] = { "send", "receive", "generate", "immature" };
+    UniValue list(UniValue::VARR);
+    for (int i = 0; i < nTx; i++) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("address", address());
+        entry.pushKV("category", categories[rng() % 4]);
+        entry.pushKV("amount", amount());
+        entry.pushKV("label", "payment \"" + std::to_string(i) + "\"\tmemo");
+        entry.pushKV("vout", (int)(rng() % 4));
+        entry.pushKV("confirmations", (int)(rng() % 10000));
+        entry.pushKV("blockhash", hex(64));
+        entry.pushKV("blockheight", 830000 + (int)(rng() % 10000));
+        entry.pushKV("blockindex", (int)(rng() % 3000));
+        entry.pushKV("blocktime", (int64_t)1713571767);
+        entry.pushKV("txid", hex(64));
+        entry.pushKV("wtxid", hex(64));
+        entry.pushKV("walletconflicts", UniValue(UniValue::VARR));
+        entry.pushKV("time", (int64_t)1713571767);
+        entry.pushKV("timereceived", (int64_t)1713571767);
+        entry.pushKV("bip125-replaceable", "no");
+        list.push_back(entry);
+    }
+    return list;
+}
+
+// Strings that are mostly escapes, or have none at all
+static UniValue makeEscapes(bool heavy)
+{
+    rngState = 4;
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 1000; i++) {
+        std::string s;
+        for (int n = 0; n < 200; n++) {
+            if (heavy) {
+                static const char special[] = "\"\\\n\t\x01\x1f/\xc3\xa9";
+                s += special[rng() % (sizeof(special) - 1)];
+            } else {
+                s += (char)('a' + rng() % 26);
+            }
+        }
+        arr.push_back(s);
+    }
+    return arr;
+}
+
+// Run fn repeatedly for at least minBenchSeconds; return nanoseconds and
+// allocations per run
+template <typename F>
+static void timeIt(F fn, double& ns, double& allocs)
+{
+    typedef std::chrono::steady_clock clock;
+    fn();                               // warm up caches and the allocator
+    unsigned long runs = 0;
+    size_t before = allocations;
+    clock::time_point start = clock::now();
+    double elapsed;
+    do {
+        fn();
+        runs++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < minBenchSeconds);
+    ns = elapsed * 1e9 / runs;
+    allocs = (double)(allocations - before) / runs;
+}
+
+static volatile size_t sink;
+
+// Time fn, which does ops operations per call, and print one result line
+template <typename F>
+static void report(const char *bench, const std::string& doc, size_t bytes, size_t ops, F fn)
+{
+    std::string name = std::string(bench) + "/" + doc;
+    if (filter && name.find(filter) == std::string::npos)
+        return;
+
+    double ns, allocs;
+    timeIt(fn, ns, allocs);
+    printf("{\"bench\":\"%s\",\"doc\":\"%s\",\"bytes\":%zu,\"ops\":%zu,\"ns_per_op\":%.1f",
+           bench, doc.c_str(), bytes, ops, ns / ops);
+    if (ops == 1)
+        printf(",\"mb_per_s\":%.1f", bytes / ns * 1e3);
+    printf(",\"allocs_per_op\":%.1f}\n", allocs / ops);
+    fflush(stdout);
+}
+
+static size_t getAll(const UniValue& val)
+{
+    switch (val.getType()) {
+    case UniValue::VNULL:
+        return 0;
+    case UniValue::VBOOL:
+        return val.get_bool();
+    case UniValue::VNUM:
+        // amounts and the like are not integers
+        if (val.getValStr().find_first_of(".eE") == std::string::npos) {
+            try {
+                return val.get_int64();
+            } catch (const std::runtime_error&) {
+                // out of range; fall through to get_real()
+            }
+        }
+        return (size_t)val.get_real();
+    case UniValue::VSTR:
+        return val.get_str().size();
+    case UniValue::VARR:
+    case UniValue::VOBJ: {
+        size_t n = 0;
+        for (size_t i = 0; i < val.size(); i++)
+            n += getAll(val[i]);
+        return n;
+        }
+    }
+    return 0;
+}
+
+static size_t countKeys(const UniValue& val)
+{
+    size_t n = val.isObject() ? val.size() : 0;
+    for (size_t i = 0; i < val.size(); i++)
+        n += countKeys(val[i]);
+    return n;
+}
+
+static size_t findAll(const UniValue& val)
+{
+    size_t n = 0;
+    if (val.isObject()) {
+        const std::vector<std::string>& keys = val.getKeys();
+        for (size_t i = 0; i < keys.size(); i++)
+            n += val[keys[i]].getType();
+    }
+    for (size_t i = 0; i < val.size(); i++)
+        n += findAll(val[i]);
+    return n;
+}
+
+static void benchDoc(const std::string& name, const UniValue& val,
+                     UniValue (*build)(int) = NULL, int buildArg = 0)
+{
+    std::string json = val.write();
+    size_t bytes = json.size();
+    UniValue tmp;
+
+    report("read", name, bytes, 1, [&]() { tmp.read(json); });
+    report("write", name, bytes, 1, [&]() { sink = val.write().size(); });
+    report("write_pretty", name, bytes, 1, [&]() { sink = val.write(4).size(); });
+    report("get", name, bytes, 1, [&]() { sink = getAll(val); });
+    size_t keys = countKeys(val);
+    if (keys)
+        report("find", name, bytes, keys, [&]() { sink = findAll(val); });
+    if (build)
+        report("build", name, bytes, 1, [&]() { sink = build(buildArg).size(); });
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        filter = argv[1];
+    if (const char *seconds = getenv("UNIVALUE_BENCH_SECONDS"))
+        minBenchSeconds = atof(seconds);
+
+    static const char *files[] = {
+        "pass1.json", "pass2.json", "pass3.json", "pass4.json",
+        "round1.json", "round2.json", "round3.json", "round4.json",
+        "round5.json", "round6.json", "round7.json",
+    };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        std::string data;
+        UniValue val;
+        if (!readFile(std::string(JSON_TEST_SRC) + "/" + files[i], data) || !val.read(data)) {
+            fprintf(stderr, "%s: cannot read JSON\n", files[i]);
+            return 1;
+        }
+        benchDoc(files[i], val);
+    }
+
+    static const int sizes[] = { 10, 100, 1000 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        int n = sizes[i];
+        benchDoc("block-" + std::to_string(n) + "tx", makeBlock(n), makeBlock, n);
+        benchDoc("mempool-" + std::to_string(n * 10) + "tx", makeMempool(n * 10), makeMempool, n * 10);
+        benchDoc("wallet-" + std::to_string(n * 10) + "tx", makeWallet(n * 10), makeWallet, n * 10);
+    }
+
+    UniValue escapes = makeEscapes(true), plain = makeEscapes(false);
+    size_t escapesBytes = escapes.write().size(), plainBytes = plain.write().size();
+    report("escape", "heavy", escapesBytes, 1, [&]() { sink = escapes.write().size(); });
+    report("escape", "none", plainBytes, 1, [&]() { sink = plain.write().size(); });
+
+    return 0;
+}
@@ -9,17 +9,33 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <cassert>
 
+class UniValueSink;
+
 class UniValue {
 public:
     enum VType { VNULL, VOBJ, VARR, VSTR, VNUM, VBOOL, };
+    class Path;
 
     UniValue() : typ(VNULL) {}
-    UniValue(UniValue::VType type, const std::string& value = std::string()) : typ(type), val(value) {}
+    UniValue(UniValue::VType type, const std::string& value = std::string())
+        : typ(type), val(type == VOBJ ? std::string() : value) {
+        memUsage = shallowUsage();
+    }
+    UniValue(const UniValue& other);
+    UniValue(UniValue&& other) noexcept
+        : typ(other.typ), val(std::move(other.val)), keys(std::move(other.keys)),
+          values(std::move(other.values)), memUsage(other.memUsage) {
+        other.memUsage = other.shallowUsage();
+    }
+    UniValue& operator=(const UniValue& other);
+    UniValue& operator=(UniValue&& other) noexcept;
     UniValue(uint64_t val_) {
         setInt(val_);
     }
@@ -45,13 +61,17 @@ public:
 
     void clear();
     void reserve(size_t n) {
+        size_t before = shallowUsage();
         if (typ == VOBJ || typ == VARR) {
-            if (typ == VOBJ)
+            if (typ == VOBJ) {
                 keys.reserve(n);
+                val.reserve(n);
+            }
             values.reserve(n);
         } else if (typ != VNULL) {
             val.reserve(n);
         }
+        memUsage += shallowUsage() - before;
     }
 
     bool setNull();
@@ -62,21 +82,36 @@ public:
     bool setInt(int val_) { return setInt((int64_t)val_); }
     bool setFloat(double val);
     bool setStr(const std::string& val);
+    // A string of 2 * size lowercase hex digits
+    bool setHex(const uint8_t *data, size_t size);
     bool setArray();
     bool setObject();
 
     enum VType getType() const { return typ; }
-    const std::string& getValStr() const { return val; }
+    const std::string& getValStr() const;
     bool empty() const { return (values.size() == 0); }
 
     size_t size() const { return values.size(); }
 
+    // Heap memory owned by this value and its descendants, in bytes: the
+    // capacity of every string and vector, the nodes themselves, and
+    // malloc's per-allocation overhead.  Kept up to date by every
+    // modification, so this is O(1).
+    size_t dynamicMemoryUsage() const { return memUsage; }
+
     bool getBool() const { return isTrue(); }
     void getObjMap(std::map<std::string,UniValue>& kv) const;
+    // Same, but without copying: keys and values refer into this object
+    void getObjMap(std::map<std::string_view,const UniValue*>& kv) const;
     bool checkObject(const std::map<std::string,UniValue::VType>& memberTypes) const;
-    const UniValue& operator[](const std::string& key) const;
+    const UniValue& operator[](std::string_view key) const;
     const UniValue& operator[](size_t index) const;
-    bool exists(const std::string& key) const { size_t i; return findKey(key, i); }
+    bool exists(std::string_view key) const { size_t i; return findKey(key, i); }
+
+    // JSON Pointer lookup, see UniValue::Path below.  resolve() returns
+    // NullUniValue if any step is missing; the batch form stores NULL.
+    const UniValue& resolve(const Path& path) const;
+    void resolve(const std::vector<Path>& paths, std::vector<const UniValue*>& out) const;
 
     bool isNull() const { return (typ == VNULL); }
     bool isTrue() const { return (typ == VBOOL) && (val == "1"); }
@@ -88,14 +123,34 @@ public:
     bool isObject() const { return (typ == VOBJ); }
 
     bool push_back(const UniValue& val);
+    bool push_back(UniValue&& val);
     bool push_backV(const std::vector<UniValue>& vec);
 
-    void __pushKV(const std::string& key, const UniValue& val);
-    bool pushKV(const std::string& key, const UniValue& val);
+    void __pushKV(std::string_view key, const UniValue& val);
+    void __pushKV(std::string_view key, UniValue&& val);
+    bool pushKV(std::string_view key, const UniValue& val);
+    bool pushKV(std::string_view key, UniValue&& val);
     bool pushKVs(const UniValue& obj);
 
     std::string write(unsigned int prettyIndent = 0,
                       unsigned int indentLevel = 0) const;
+    // Same output as write(), but large arrays and objects are split into
+    // chunks which are serialized concurrently on up to nThreads workers
+    // (0 = one per hardware thread).
+    std::string writeParallel(unsigned int prettyIndent = 0,
+                              unsigned int indentLevel = 0,
+                              unsigned int nThreads = 0) const;
+
+    // Turn the tree into an immutable snapshot shared by reference
+    // counting.  A UniValue has no hidden mutable state, so any number of
+    // threads may use the const API of a snapshot concurrently without
+    // locking.  The rvalue form moves the tree instead of copying it.
+    std::shared_ptr<const UniValue> freeze() const &;
+    std::shared_ptr<const UniValue> freeze() &&;
+
+    // Reallocate every string and array in the tree at exactly its size,
+    // releasing the slack left by incremental building
+    void compact();
 
     bool read(const char *raw, size_t len);
     bool read(const char *raw) { return read(raw, strlen(raw)); }
@@ -103,15 +158,76 @@ public:
         return read(rawStr.data(), rawStr.size());
     }
 
+    // CBOR (RFC 8949) encoding, see univalue_cbor.cpp
+    std::string writeCBOR() const;
+    bool writeCBOR(UniValueSink& sink) const;
+    bool readCBOR(const unsigned char *data, size_t len);
+    bool readCBOR(const std::string& raw) {
+        return readCBOR((const unsigned char *)raw.data(), raw.size());
+    }
+
+    // Position-independent snapshot for UniValueView, see univalue_view.h
+    bool writeSnapshot(std::string& out) const;
+
+    // MessagePack encoding, see univalue_msgpack.cpp
+    std::string writeMsgPack() const;
+    bool writeMsgPack(UniValueSink& sink) const;
+    bool readMsgPack(const unsigned char *data, size_t len);
+    bool readMsgPack(const std::string& raw) {
+        return readMsgPack((const unsigned char *)raw.data(), raw.size());
+    }
+
 private:
+    friend class UniValueReader;
+
     UniValue::VType typ;
-    std::string val;                       // numbers are stored as C++ strings
+    std::string val;                       // numbers are stored as C++ strings;
+                                           // for objects, see keyTag()
     std::vector<std::string> keys;
     std::vector<UniValue> values;
+    size_t memUsage = 0;                   // see dynamicMemoryUsage()
+
+    // Estimated heap usage of an n byte allocation, as for glibc malloc
+    static size_t mallocUsage(size_t n) {
+        if (n == 0)
+            return 0;
+        if (sizeof(void *) == 8)
+            return ((n + 31) >> 4) << 4;
+        return ((n + 15) >> 3) << 3;
+    }
+    static size_t stringUsage(const std::string& s) {
+        // short strings live inside the object
+        return s.capacity() > std::string().capacity() ? mallocUsage(s.capacity() + 1) : 0;
+    }
+    // Usage of val and of the keys and values arrays, excluding what the
+    // keys and children themselves own
+    size_t shallowUsage() const {
+        return stringUsage(val) + mallocUsage(keys.capacity() * sizeof(std::string)) +
+               mallocUsage(values.capacity() * sizeof(UniValue));
+    }
+    void updateUsage();
+    static void compactString(std::string& s);
 
-    bool findKey(const std::string& key, size_t& retIdx) const;
+    // An object keeps one byte per key in val, mixed from the key's
+    // length and its first, middle and last bytes, so that findKey() can
+    // rule out most keys without comparing them.  Hashing the whole key
+    // would cost more than the comparisons it saves.
+    static unsigned char keyTag(std::string_view key) {
+        size_t n = key.size();
+        if (n == 0)
+            return 0;
+        uint32_t h = (uint32_t)n * 0x9e3779b1U;
+        h ^= ((unsigned char)key[0] | (unsigned char)key[n / 2] << 8 |
+              (uint32_t)(unsigned char)key[n - 1] << 16) * 0x85ebca6bU;
+        return h >> 24;
+    }
+
+    bool findKey(std::string_view key, size_t& retIdx) const;
+    void writeValue(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
+    void writeRange(unsigned int prettyIndent, unsigned int indentLevel,
+                    size_t first, size_t last, unsigned int nThreads, std::string& s) const;
 
 public:
     // Strict type-specific getters, these throw std::runtime_error if the
@@ -120,14 +236,57 @@ public:
     const std::vector<UniValue>& getValues() const;
     bool get_bool() const;
     const std::string& get_str() const;
+    std::string_view get_str_view() const;
+    std::string_view key(size_t index) const;
     int get_int() const;
     int64_t get_int64() const;
     double get_real() const;
     const UniValue& get_obj() const;
     const UniValue& get_array() const;
+    // Decode a hex string (either case), e.g. a txid or script.  The
+    // vector form leaves out as it was if it throws; the fixed-size form
+    // requires exactly 2 * size digits, and may have written part of out.
+    void get_hex(std::vector<uint8_t>& out) const;
+    void get_hex(uint8_t *out, size_t size) const;
 
     enum VType type() const { return getType(); }
-    friend const UniValue& find_value( const UniValue& obj, const std::string& name);
+    friend const UniValue& find_value( const UniValue& obj, std::string_view name);
+};
+
+/**
+ * A JSON Pointer (RFC 6901) compiled once into pre-split, unescaped
+ * segments, so that UniValue::resolve() can walk a tree without building
+ * any temporary strings.
+ */
+class UniValue::Path {
+public:
+    Path() {}
+    // Throws std::runtime_error if pointer is not a valid JSON Pointer
+    explicit Path(const std::string& pointer);
+
+    // Returns false (leaving the path empty) if pointer is not valid
+    bool parse(const std::string& pointer);
+
+    const std::string& str() const { return pointer; }
+    size_t size() const { return segments.size(); }
+
+private:
+    friend class UniValue;
+
+    struct Segment {
+        std::string key;
+        size_t index;           // array index, if isIndex
+        bool isIndex;
+
+        bool operator==(const Segment& other) const {
+            return key == other.key;
+        }
+    };
+
+    std::string pointer;
+    std::vector<Segment> segments;
+
+    static const UniValue *step(const UniValue *node, const Segment& seg);
 };
 
 enum jtokentype {
@@ -185,6 +344,11 @@ static inline bool json_isspace(int ch)
 
 extern const UniValue NullUniValue;
 
-const UniValue& find_value( const UniValue& obj, const std::string& name);
+inline const std::string& UniValue::getValStr() const
+{
+    return typ == VOBJ ? NullUniValue.val : val;
+}
+
+const UniValue& find_value( const UniValue& obj, std::string_view name);
 
 #endif // __UNIVALUE_H__
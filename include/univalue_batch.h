@@ -0,0 +1,46 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_BATCH_H__
+#define __UNIVALUE_BATCH_H__
+
+#include <functional>
+#include <string>
+
+#include "univalue.h"
+#include "univalue_stream.h"
+
+// Called once per request of a batch, possibly from several threads at
+// once.  Returns false if the request gets no reply (a notification).
+typedef std::function<bool(const UniValue& request, UniValue& reply)> UniValueBatchHandler;
+
+/**
+ * Process a JSON-RPC 2.0 batch: a top-level array of requests.
+ *
+ * A quick scan finds where each element starts and ends, without
+ * tokenizing.  The elements are then parsed independently, and handled,
+ * on up to nThreads work-stealing workers (0 = one per hardware thread),
+ * so a batch takes about as long as its slowest request rather than the
+ * sum of them all.  The calling thread is one of the workers; the others
+ * come from a pool of threads that is kept for later batches.  Replies
+ * are written to out as an array, in request order; if no request
+ * produced a reply, nothing is written.
+ *
+ * An empty batch is answered, as JSON-RPC 2.0 requires, with a single
+ * Invalid Request error object (code -32600, id null) rather than an
+ * array.
+ *
+ * Returns false, without calling the handler at all, if raw is not a
+ * valid JSON array, and false if out fails.  An exception thrown by the
+ * handler is rethrown once all workers have stopped.
+ */
+bool processJsonBatch(const char *raw, size_t size, const UniValueBatchHandler& handler,
+                      UniValueWriter& out, unsigned int nThreads = 0);
+static inline bool processJsonBatch(const std::string& raw, const UniValueBatchHandler& handler,
+                                    UniValueWriter& out, unsigned int nThreads = 0)
+{
+    return processJsonBatch(raw.data(), raw.size(), handler, out, nThreads);
+}
+
+#endif // __UNIVALUE_BATCH_H__
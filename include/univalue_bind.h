@@ -0,0 +1,312 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_BIND_H__
+#define __UNIVALUE_BIND_H__
+
+#include <stdint.h>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "univalue.h"
+#include "univalue_stream.h"
+
+/**
+ * Declarative binding between JSON objects and C++ structs.  A struct
+ * describes its members once, by specializing UniValueFields:
+ *
+ *     struct Input {
+ *         std::string txid;
+ *         int vout;
+ *         std::optional<bool> spent;
+ *     };
+ *
+ *     template<> struct UniValueFields<Input> {
+ *         static constexpr auto fields = std::make_tuple(
+ *             UniValueField("txid", &Input::txid),
+ *             UniValueField("vout", &Input::vout),
+ *             UniValueField("spent", &Input::spent));
+ *     };
+ *
+ * decodeJSON() then fills an Input straight from JSON text, and
+ * encodeJSON() writes one straight to JSON text, without building a
+ * UniValue tree either way.
+ *
+ * Members may be bool, int, int64_t, double, std::string, another bound
+ * struct, std::vector of any of these, or std::optional of any of these.
+ * std::vector<unsigned char> is the exception: it holds binary data, which
+ * is carried as a hex string and decoded straight into the vector.
+ * Every member is required except std::optional ones, which are left
+ * empty when the key is missing or null.  Unknown keys are skipped, and
+ * as with find_value() the first of several duplicate keys wins.  When
+ * encoding, empty std::optional members are left out of the object.
+ */
+template<typename T>
+struct UniValueFields;
+
+template<typename S, typename F>
+struct UniValueField {
+    std::string_view key;
+    F S::*member;
+
+    constexpr UniValueField(std::string_view key_, F S::*member_)
+        : key(key_), member(member_) {}
+};
+
+/**
+ * Type-erased decoding operations for one C++ type; an implementation
+ * detail of decodeJSON().  value() is called at the start of every JSON
+ * value bound to the type: it stores a scalar, or for a container returns
+ * the object that receives its contents.  Errors are returned as the
+ * message the corresponding strict getter would throw.
+ */
+struct UniValueCodec {
+    const char *expected;           // error when the value is missing
+    bool isOptional;
+
+    const char *(*value)(void *dst, UniValue::VType type, const std::string& text,
+                         void *& child, const UniValueCodec *& childCodec);
+    // struct: the member for key, or NULL to skip it
+    void *(*field)(void *obj, std::string_view key, const UniValueCodec *& codec, size_t& index);
+    // struct: error for the first required member not in seen
+    const char *(*finish)(uint64_t seen);
+    // std::vector: append an element and return it
+    void *(*element)(void *obj, const UniValueCodec *& codec);
+    // binary: the buffer a hex string is decoded into, or NULL
+    std::vector<unsigned char> *(*bytes)(void *dst);
+};
+
+extern const UniValueCodec univalue_codec_bool;
+extern const UniValueCodec univalue_codec_int;
+extern const UniValueCodec univalue_codec_int64;
+extern const UniValueCodec univalue_codec_real;
+extern const UniValueCodec univalue_codec_str;
+extern const UniValueCodec univalue_codec_bytes;
+
+template<typename T, typename = void>
+struct UniValueCodecFor;
+
+template<> struct UniValueCodecFor<bool> {
+    static const UniValueCodec& get() { return univalue_codec_bool; }
+};
+template<> struct UniValueCodecFor<int> {
+    static const UniValueCodec& get() { return univalue_codec_int; }
+};
+template<> struct UniValueCodecFor<int64_t> {
+    static const UniValueCodec& get() { return univalue_codec_int64; }
+};
+template<> struct UniValueCodecFor<double> {
+    static const UniValueCodec& get() { return univalue_codec_real; }
+};
+template<> struct UniValueCodecFor<std::string> {
+    static const UniValueCodec& get() { return univalue_codec_str; }
+};
+template<> struct UniValueCodecFor<std::vector<unsigned char>> {
+    static const UniValueCodec& get() { return univalue_codec_bytes; }
+};
+
+template<typename U>
+struct UniValueCodecFor<std::vector<U>> {
+    static const char *value(void *dst, UniValue::VType type, const std::string& /* text */,
+                             void *& child, const UniValueCodec *& childCodec) {
+        if (type != UniValue::VARR)
+            return get().expected;
+        static_cast<std::vector<U> *>(dst)->clear();
+        child = dst;
+        childCodec = &get();
+        return NULL;
+    }
+    static void *element(void *obj, const UniValueCodec *& codec) {
+        std::vector<U>& vec = *static_cast<std::vector<U> *>(obj);
+        vec.emplace_back();
+        codec = &UniValueCodecFor<U>::get();
+        return &vec.back();
+    }
+    static const UniValueCodec& get() {
+        static const UniValueCodec codec = {
+            "JSON value is not an array as expected", false, value, NULL, NULL, element, NULL
+        };
+        return codec;
+    }
+};
+
+template<typename U>
+struct UniValueCodecFor<std::optional<U>> {
+    static const char *value(void *dst, UniValue::VType type, const std::string& text,
+                             void *& child, const UniValueCodec *& childCodec) {
+        std::optional<U>& opt = *static_cast<std::optional<U> *>(dst);
+        if (type == UniValue::VNULL) {
+            opt.reset();
+            return NULL;
+        }
+        opt.emplace();
+        return UniValueCodecFor<U>::get().value(&*opt, type, text, child, childCodec);
+    }
+    static std::vector<unsigned char> *bytes(void *dst) {
+        std::optional<U>& opt = *static_cast<std::optional<U> *>(dst);
+        opt.emplace();
+        return UniValueCodecFor<U>::get().bytes(&*opt);
+    }
+    static const UniValueCodec& get() {
+        static const UniValueCodec codec = {
+            UniValueCodecFor<U>::get().expected, true, value, NULL, NULL, NULL,
+            UniValueCodecFor<U>::get().bytes ? bytes : NULL
+        };
+        return codec;
+    }
+};
+
+template<typename T>
+struct UniValueCodecFor<T, std::void_t<decltype(UniValueFields<T>::fields)>> {
+    static constexpr const auto& fields = UniValueFields<T>::fields;
+    static constexpr size_t count = std::tuple_size<std::decay_t<decltype(fields)>>::value;
+    static_assert(count <= 64, "at most 64 fields per struct");
+
+    template<size_t I>
+    using FieldType = std::remove_reference_t<
+        decltype(std::declval<T&>().*(std::get<I>(fields).member))>;
+
+    static const char *value(void *dst, UniValue::VType type, const std::string& /* text */,
+                             void *& child, const UniValueCodec *& childCodec) {
+        if (type != UniValue::VOBJ)
+            return get().expected;
+        child = dst;
+        childCodec = &get();
+        return NULL;
+    }
+
+    template<size_t... I>
+    static void *field(T& obj, std::string_view key, const UniValueCodec *& codec,
+                       size_t& index, std::index_sequence<I...>) {
+        void *ptr = NULL;
+        ((ptr == NULL && key == std::get<I>(fields).key ?
+          (ptr = &(obj.*(std::get<I>(fields).member)),
+           codec = &UniValueCodecFor<FieldType<I>>::get(), index = I) : 0), ...);
+        return ptr;
+    }
+    static void *field(void *obj, std::string_view key, const UniValueCodec *& codec, size_t& index) {
+        return field(*static_cast<T *>(obj), key, codec, index, std::make_index_sequence<count>());
+    }
+
+    template<size_t... I>
+    static const char *finish(uint64_t seen, std::index_sequence<I...>) {
+        const char *err = NULL;
+        ((err == NULL && !(seen & (1ULL << I)) && !UniValueCodecFor<FieldType<I>>::get().isOptional ?
+          (err = UniValueCodecFor<FieldType<I>>::get().expected) : NULL), ...);
+        return err;
+    }
+    static const char *finish(uint64_t seen) {
+        return finish(seen, std::make_index_sequence<count>());
+    }
+
+    static const UniValueCodec& get() {
+        static const UniValueCodec codec = {
+            "JSON value is not an object as expected", false, value, field, finish, NULL, NULL
+        };
+        return codec;
+    }
+};
+
+// Non-template driver: run readJsonSAX() over raw, decoding into out
+bool decodeJSON(const char *raw, size_t size, void *out, const UniValueCodec& codec,
+                std::string& error);
+
+// Decode JSON text into a bound type.  Throws std::runtime_error with the
+// strict getters' message (e.g. "JSON value is not an integer as expected")
+// if the text does not match T, or "JSON parse error" if it is malformed.
+template<typename T>
+void decodeJSON(const char *raw, size_t size, T& out)
+{
+    std::string error;
+    if (!decodeJSON(raw, size, &out, UniValueCodecFor<T>::get(), error))
+        throw std::runtime_error(error);
+}
+
+template<typename T>
+void decodeJSON(const std::string& raw, T& out)
+{
+    decodeJSON(raw.data(), raw.size(), out);
+}
+
+template<typename T, typename = void>
+struct UniValueEncoder {
+    static bool write(UniValueWriter& w, const T& val) { return w.value(val); }
+};
+
+template<typename U>
+struct UniValueEncoder<std::vector<U>> {
+    static bool write(UniValueWriter& w, const std::vector<U>& vec) {
+        if (!w.beginArray())
+            return false;
+        for (size_t i = 0; i < vec.size(); i++) {
+            if (!UniValueEncoder<U>::write(w, vec[i]))
+                return false;
+        }
+        return w.endArray();
+    }
+};
+
+template<>
+struct UniValueEncoder<std::vector<unsigned char>> {
+    static bool write(UniValueWriter& w, const std::vector<unsigned char>& vec) {
+        return w.valueHex(vec.data(), vec.size());
+    }
+};
+
+template<typename U>
+struct UniValueEncoder<std::optional<U>> {
+    static bool write(UniValueWriter& w, const std::optional<U>& opt) {
+        return opt ? UniValueEncoder<U>::write(w, *opt) : w.valueNull();
+    }
+};
+
+template<typename T>
+struct UniValueEncoder<T, std::void_t<decltype(UniValueFields<T>::fields)>> {
+    template<typename S, typename F>
+    static bool member(UniValueWriter& w, const T& obj, const UniValueField<S, F>& f) {
+        return w.key(f.key) && UniValueEncoder<F>::write(w, obj.*(f.member));
+    }
+    template<typename S, typename U>
+    static bool member(UniValueWriter& w, const T& obj, const UniValueField<S, std::optional<U>>& f) {
+        const std::optional<U>& opt = obj.*(f.member);
+        return !opt || (w.key(f.key) && UniValueEncoder<U>::write(w, *opt));
+    }
+
+    static bool write(UniValueWriter& w, const T& obj) {
+        return w.beginObject() &&
+               std::apply([&w, &obj](const auto&... f) { return (member(w, obj, f) && ...); },
+                          UniValueFields<T>::fields) &&
+               w.endObject();
+    }
+};
+
+// Write a bound type as the next value of w, with the same bytes as
+// building the equivalent UniValue (members in declaration order) and
+// writing that.  Returns false if w fails, e.g. on a non-finite double.
+template<typename T>
+bool encodeJSON(UniValueWriter& w, const T& val)
+{
+    return UniValueEncoder<T>::write(w, val);
+}
+
+// Serialize a bound type; the result matches UniValue::write(prettyIndent)
+template<typename T>
+std::string encodeJSON(const T& val, unsigned int prettyIndent = 0)
+{
+    std::string out;
+    UniValueStringSink sink(out);
+    UniValueWriter w(sink, prettyIndent);
+    if (!encodeJSON(w, val) || !w.finish())
+        throw std::runtime_error("JSON value could not be serialized");
+    return out;
+}
+
+#endif // __UNIVALUE_BIND_H__
@@ -0,0 +1,51 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_COUNTERS_H__
+#define __UNIVALUE_COUNTERS_H__
+
+#include <stdint.h>
+
+#include "univalue.h"
+
+/**
+ * Counts of the work the library has done, for finding out where the time
+ * went in a slow request: tokenizing, building nodes, key lookups, deep
+ * copies or serialization.
+ *
+ * Counting is compiled in with ./configure --enable-instrumentation.
+ * Each thread counts into its own block, so counting takes no locks and
+ * threads do not contend; a snapshot adds the blocks up.  Without the
+ * option the hooks compile to nothing, enabled() is false and every
+ * snapshot is zero.
+ *
+ * Counts only grow, until reset() starts them again from zero; a
+ * metrics exporter can either scrape snapshot() and report differences,
+ * or reset() after each scrape.
+ */
+struct UniValueCounters {
+    uint64_t tokens[JTOK_STRING + 1];   // read by the tokenizer, by jtokentype
+    uint64_t bytesScanned;              // input consumed by the tokenizer
+    uint64_t stringBytes;               // of which inside strings (UTF-8 checked)
+    uint64_t nodes[UniValue::VBOOL + 1];        // built by read(), by VType
+    uint64_t nodeBytes[UniValue::VBOOL + 1];    // heap owned by those, less children
+    uint64_t findKeyCalls;
+    uint64_t findKeyProbes;             // keys compared with the one sought
+    uint64_t copies;                    // UniValue copy constructions and assignments
+    uint64_t copyBytes;                 // dynamicMemoryUsage() of the values copied
+    uint64_t writeCalls;                // UniValue::write()
+    uint64_t writeBytes;                // text returned
+    uint64_t writeGrowth;               // writes that outgrew the initial buffer
+
+    // Whether the library was built with counting
+    static bool enabled();
+    // The sum over all threads, including ones that have exited
+    static UniValueCounters snapshot();
+    // The calling thread's counts
+    static UniValueCounters threadSnapshot();
+    // Start every thread's counts again from zero
+    static void reset();
+};
+
+#endif // __UNIVALUE_COUNTERS_H__
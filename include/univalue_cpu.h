@@ -0,0 +1,44 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_CPU_H__
+#define __UNIVALUE_CPU_H__
+
+/**
+ * The library's bulk loops over bytes (scanning strings and structure,
+ * checking UTF-8, escaping, hex coding and key lookup) come in versions
+ * for several instruction sets, and the best one the CPU has is chosen
+ * when the library is loaded.  So one build runs on any machine of its
+ * architecture, and uses AVX2 or AVX-512 on the ones that have it.
+ *
+ * Every tier gives exactly the same results; only the speed differs.
+ * To benchmark or debug one, set the environment variable UNIVALUE_CPU
+ * to its name, or call uvSetCPUTier().  A tier the machine or the build
+ * does not support is never used: UNIVALUE_CPU falls back to the best
+ * tier below the one named.
+ */
+enum UniValueCPUTier {
+    CPU_SCALAR,         // portable C++, always supported
+    CPU_SSE2,           // x86-64 baseline
+    CPU_SSE42,
+    CPU_AVX2,
+    CPU_AVX512,         // AVX-512F and AVX-512BW
+    CPU_NEON,           // aarch64 baseline
+};
+
+// The tier in use
+UniValueCPUTier uvCPUTier();
+// The tier chosen at load time, ignoring UNIVALUE_CPU
+UniValueCPUTier uvCPUBestTier();
+// Whether both this machine and this build of the library support tier
+bool uvCPUSupports(UniValueCPUTier tier);
+// Use tier from now on, in every thread; false, changing nothing, if it
+// is not supported
+bool uvSetCPUTier(UniValueCPUTier tier);
+
+// "scalar", "sse2", "sse4.2", "avx2", "avx512" or "neon"
+const char *uvCPUTierName(UniValueCPUTier tier);
+bool uvCPUTierFromName(const char *name, UniValueCPUTier& tier);
+
+#endif // __UNIVALUE_CPU_H__
@@ -0,0 +1,90 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_JSONPATH_H__
+#define __UNIVALUE_JSONPATH_H__
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "univalue.h"
+
+/**
+ * Compiled JSONPath query, e.g.
+ *
+ *     $.result.tx[*].vout[?(@.value > 1)].scriptPubKey.address
+ *
+ * Supported syntax:
+ *
+ *     $                 the root
+ *     .name  ['name']   object member ("name" quoting also accepted)
+ *     [n]               array element, n >= 0
+ *     .*  [*]           every member or element
+ *     ..x               x applied at any depth (x is one of the above)
+ *     [?(@.a.b)]        children where the relative path exists
+ *     [?(@.a OP lit)]   children where it compares true with a literal;
+ *                       OP is == != < <= > >=, lit a number, quoted
+ *                       string, true, false or null
+ *
+ * Comparisons follow RFC 9535: numbers compare numerically, strings by
+ * bytes, and values of different types are only ever unequal.
+ *
+ * Results are in document order.  select() works over a parsed tree.
+ * selectJSON() works on JSON text via readJsonSAX(): subtrees that cannot
+ * match are skipped without being built, and only matches (and, for
+ * filters, the candidates being tested) become UniValues.
+ */
+class UniValueJSONPath {
+public:
+    UniValueJSONPath() {}
+    // Throws std::runtime_error if path is not a supported JSONPath
+    explicit UniValueJSONPath(const std::string& path);
+
+    bool parse(const std::string& path);
+    const std::string& str() const { return text; }
+
+    void select(const UniValue& root, std::vector<const UniValue*>& out) const;
+
+    // false if raw is not valid JSON
+    bool selectJSON(const char *raw, size_t size, std::vector<UniValue>& out) const;
+    bool selectJSON(const std::string& raw, std::vector<UniValue>& out) const {
+        return selectJSON(raw.data(), raw.size(), out);
+    }
+
+private:
+    enum StepKind { STEP_KEY, STEP_INDEX, STEP_WILDCARD, STEP_FILTER };
+    enum FilterOp { OP_EXISTS, OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE };
+
+    struct Step {
+        StepKind kind;
+        bool recursive;             // ".." applies at any depth
+        std::string key;
+        size_t index;
+        FilterOp op;
+        UniValue::Path target;      // filter: relative path from @
+        UniValue literal;
+    };
+
+    // The evaluation state is the set of steps still to be matched, one
+    // bit per step, so a query has at most MAX_STEPS steps; the bit after
+    // the last step means "matched".
+    static const size_t MAX_STEPS = 63;
+
+    std::string text;
+    std::vector<Step> steps;
+
+    friend class UniValueJSONPathHandler;
+
+    uint64_t matched() const { return 1ULL << steps.size(); }
+    bool hasFilter(uint64_t states) const;
+    uint64_t advance(uint64_t states, bool isIndex, std::string_view key, size_t index,
+                     const UniValue *child) const;
+    static bool test(const Step& s, const UniValue& child);
+    void select(const UniValue& node, uint64_t states, std::vector<const UniValue*>& out) const;
+};
+
+#endif // __UNIVALUE_JSONPATH_H__
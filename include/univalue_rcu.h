@@ -0,0 +1,66 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_RCU_H__
+#define __UNIVALUE_RCU_H__
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "univalue.h"
+
+/**
+ * Read-copy-update slot holding the current snapshot of a shared value,
+ * such as parsed configuration or a cached RPC result.
+ *
+ * Readers call load() and keep using the snapshot they got for as long as
+ * they like; a writer publishes a replacement with store() or update()
+ * without waiting for them.  An old snapshot is freed when its last
+ * reader drops it.  All members may be called concurrently.
+ */
+class UniValueRCU {
+public:
+    UniValueRCU() : current(UniValue().freeze()) {}
+    explicit UniValueRCU(std::shared_ptr<const UniValue> snapshot)
+        : current(snapshot ? std::move(snapshot) : UniValue().freeze()) {}
+
+    std::shared_ptr<const UniValue> load() const {
+        return std::atomic_load_explicit(&current, std::memory_order_acquire);
+    }
+
+    void store(std::shared_ptr<const UniValue> snapshot) {
+        if (!snapshot)
+            snapshot = UniValue().freeze();
+        std::atomic_store_explicit(&current, std::move(snapshot), std::memory_order_release);
+    }
+    void store(UniValue&& val) {
+        std::atomic_store_explicit(&current, std::move(val).freeze(), std::memory_order_release);
+    }
+
+    // Publish a copy of the current value modified by fn(UniValue&).  If
+    // another writer publishes first, fn is applied again to the newer
+    // value, so it should have no other side effects.  Returns the
+    // snapshot published.
+    template <typename F>
+    std::shared_ptr<const UniValue> update(F fn) {
+        std::shared_ptr<const UniValue> old = load();
+        while (true) {
+            UniValue copy(*old);
+            fn(copy);
+            std::shared_ptr<const UniValue> next = std::move(copy).freeze();
+            if (std::atomic_compare_exchange_strong_explicit(&current, &old, next,
+                    std::memory_order_acq_rel, std::memory_order_acquire))
+                return next;
+        }
+    }
+
+private:
+    std::shared_ptr<const UniValue> current;
+
+    UniValueRCU(const UniValueRCU&);
+    UniValueRCU& operator=(const UniValueRCU&);
+};
+
+#endif // __UNIVALUE_RCU_H__
@@ -0,0 +1,128 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_READER_H__
+#define __UNIVALUE_READER_H__
+
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "univalue.h"
+
+// Why the last UniValueReader::read() failed
+enum UniValueReadError {
+    READ_OK = 0,
+    READ_SYNTAX,                // not valid JSON
+    READ_DEPTH,                 // nested deeper than maxDepth
+    READ_BYTES,                 // tree would use more than maxBytes
+    READ_NODES,                 // more than maxNodes values
+    READ_STRING,                // a string, key or number over maxString
+    READ_MEMBERS,               // an object or array over maxMembers
+    READ_STEPS,                 // more than maxSteps tokens
+    READ_TIME,                  // took longer than maxTime
+    READ_ABORTED,               // the usage callback returned false
+};
+
+const char *uvReadErrorName(UniValueReadError err);
+
+/**
+ * Resource limits for UniValueReader.  Each is checked as the document is
+ * tokenized and built, so input that exceeds one is rejected as soon as
+ * it does, without the rest being read.  The defaults impose nothing
+ * beyond the depth limit that read() always applies.
+ */
+struct UniValueReadLimits {
+    size_t maxDepth = 512;          // at most 512 whatever the setting
+    size_t maxBytes = SIZE_MAX;     // dynamicMemoryUsage() of the result
+    size_t maxNodes = SIZE_MAX;     // values of any type, including the root
+    size_t maxString = SIZE_MAX;    // bytes, after unescaping
+    size_t maxMembers = SIZE_MAX;   // in any one object or array
+    size_t maxSteps = SIZE_MAX;     // tokens, including punctuation
+    // Wall-clock time, sampled every few hundred tokens; zero for none
+    std::chrono::steady_clock::duration maxTime = std::chrono::steady_clock::duration::zero();
+};
+
+// See UniValueReader::setUsageCallback()
+typedef std::function<bool(size_t usage)> UniValueUsageCallback;
+
+/**
+ * Parser context for reading many documents in a row, e.g. one per
+ * worker thread.  It keeps its scratch stack and token buffer between
+ * reads, along with a pool of recycled nodes whose strings and vectors
+ * keep their capacity.
+ *
+ * read() recycles the previous contents of the destination tree before
+ * parsing into it, so that repeatedly parsing similar documents into the
+ * same UniValue reaches a steady state that allocates almost nothing.
+ * Nodes are handed out again in the order they were recycled, so a node
+ * tends to come back in the same position with enough room.
+ *
+ * A usage callback, if set, is called during parsing with the running
+ * dynamicMemoryUsage() of the tree being built, each time it grows.
+ * Returning false aborts the parse with READ_ABORTED.  For a fixed
+ * budget, UniValueReadLimits::maxBytes does the same without a call.
+ *
+ * In exact-capacity mode, a quick structural scan first counts the
+ * members of every array and object, and the tree is then built with
+ * each container reserved to exactly that size.  This takes a little
+ * longer than a normal read, and forgoes the pool, but leaves no slack
+ * behind: the choice for documents that are kept around.
+ *
+ * A reader is not thread safe; use one per thread.
+ */
+class UniValueReader {
+public:
+    UniValueReader() {}
+
+    // Same result as out.read(raw, size)
+    bool read(const char *raw, size_t size, UniValue& out);
+    bool read(const std::string& raw, UniValue& out) {
+        return read(raw.data(), raw.size(), out);
+    }
+
+    // Limits for later reads; a read that exceeds one fails, and error()
+    // says which
+    void setLimits(const UniValueReadLimits& limits_) { limits = limits_; }
+    const UniValueReadLimits& getLimits() const { return limits; }
+    UniValueReadError error() const { return err; }
+
+    void setExactCapacity(bool exact_) { exact = exact_; }
+    bool exactCapacity() const { return exact; }
+
+    // Called with the running dynamicMemoryUsage() of the tree being
+    // read whenever it grows; returning false aborts the read.  Pass an
+    // empty function to remove it.
+    void setUsageCallback(const UniValueUsageCallback& fn) { usageCallback = fn; }
+
+    // Empty val, keeping its storage in the pool for later reads
+    void recycle(UniValue& val);
+
+    // Number of recycled nodes waiting to be reused
+    size_t pooled() const { return pool.size(); }
+    // Free the pool and scratch buffers
+    void release();
+
+private:
+    std::vector<UniValue*> stack;
+    std::string tokenVal;
+    std::vector<UniValue> pool;
+    UniValueUsageCallback usageCallback;
+    UniValueReadLimits limits;
+    UniValueReadError err = READ_OK;
+    bool exact = false;
+    std::vector<size_t> counts;         // exact mode: members per container
+    std::vector<size_t> scanStack;
+
+    friend class UniValue;
+
+    bool parse(const char *raw, size_t size, UniValue& out);
+    void recycleChildren(UniValue& val);
+    UniValue& newChild(UniValue *parent, UniValue::VType type, size_t& usage);
+};
+
+#endif // __UNIVALUE_READER_H__
@@ -0,0 +1,58 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_SAX_H__
+#define __UNIVALUE_SAX_H__
+
+#include <string>
+#include <vector>
+
+#include "univalue.h"
+
+/**
+ * Event interface for readJsonSAX(), which parses JSON text without
+ * building a UniValue tree.  Each callback returns one of:
+ *
+ *   SAX_OK     continue parsing
+ *   SAX_SKIP   from onKey(): skip the member's value; from onBeginObject()
+ *              or onBeginArray(): skip the container's contents, and do
+ *              not deliver its end event.  Skipped input is still checked
+ *              for well-formedness, but produces no events.
+ *   SAX_STOP   abort; readJsonSAX() returns false
+ *
+ * A handler that wants a value as binary can return a buffer from
+ * hexBuffer(), which is called before each string value is read.  If the
+ * string is an even number of hex digits, it is decoded straight into
+ * that buffer and delivered by onHex(), without going through a
+ * std::string; any other string is delivered by onString() as usual, and
+ * leaves the buffer as it was.
+ */
+class UniValueSAXHandler {
+public:
+    enum Action { SAX_STOP, SAX_OK, SAX_SKIP };
+
+    virtual ~UniValueSAXHandler() {}
+
+    virtual Action onNull() { return SAX_OK; }
+    virtual Action onBool(bool /* val */) { return SAX_OK; }
+    virtual Action onNumber(const std::string& /* text */) { return SAX_OK; }
+    virtual Action onString(const std::string& /* str */) { return SAX_OK; }
+    virtual std::vector<unsigned char> *hexBuffer() { return NULL; }
+    virtual Action onHex(const std::vector<unsigned char>& /* bytes */) { return SAX_OK; }
+    virtual Action onKey(const std::string& /* key */) { return SAX_OK; }
+    virtual Action onBeginObject() { return SAX_OK; }
+    virtual Action onEndObject() { return SAX_OK; }
+    virtual Action onBeginArray() { return SAX_OK; }
+    virtual Action onEndArray() { return SAX_OK; }
+};
+
+// Parse exactly one JSON value, with the same grammar and limits as
+// UniValue::read().  Returns false on malformed input or SAX_STOP.
+bool readJsonSAX(const char *raw, size_t size, UniValueSAXHandler& handler);
+static inline bool readJsonSAX(const std::string& raw, UniValueSAXHandler& handler)
+{
+    return readJsonSAX(raw.data(), raw.size(), handler);
+}
+
+#endif // __UNIVALUE_SAX_H__
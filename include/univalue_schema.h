@@ -0,0 +1,94 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_SCHEMA_H__
+#define __UNIVALUE_SCHEMA_H__
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "univalue.h"
+
+/**
+ * Reusable description of a JSON object, built once and used to validate
+ * many values.  Supersedes UniValue::checkObject():
+ *
+ *     UniValueSchema req(UniValueSchema::REJECT_UNKNOWN);
+ *     req.required("method", UniValue::VSTR).length(1, 64);
+ *     req.optional("id", UniValue::VNUM).range(0, INT32_MAX);
+ *     req.optional("params", UniValue::VOBJ).nested(paramsSchema);
+ *
+ * Validation makes a single pass over the object's members, looking each
+ * key up in a sorted table, and reports every violation rather than
+ * stopping at the first.  validateJSON() does the same directly on JSON
+ * text via readJsonSAX(), so a bad request is rejected without building
+ * a tree, and members the schema does not care about are skipped.
+ */
+class UniValueSchema {
+public:
+    enum UnknownKeys {
+        ALLOW_UNKNOWN,              // members not in the schema are ignored
+        REJECT_UNKNOWN,             // members not in the schema are errors
+    };
+
+    explicit UniValueSchema(UnknownKeys unknown_ = ALLOW_UNKNOWN)
+        : unknown(unknown_) {}
+
+    // Add a member; the constraint setters below apply to the most
+    // recently added one.  Adding a key twice replaces its description.
+    UniValueSchema& required(std::string_view key, UniValue::VType type);
+    UniValueSchema& optional(std::string_view key, UniValue::VType type);
+
+    // Numbers must be integers within [minVal, maxVal]
+    UniValueSchema& range(int64_t minVal, int64_t maxVal);
+    // Strings must be [minLen, maxLen] bytes long
+    UniValueSchema& length(size_t minLen, size_t maxLen);
+    // An object member is validated against schema; for an array member,
+    // every element must be an object valid against schema
+    UniValueSchema& nested(const UniValueSchema& schema);
+
+    bool validate(const UniValue& val) const;
+    bool validate(const UniValue& val, std::vector<std::string>& errors) const;
+
+    // Parse and validate JSON text without building a tree.  Malformed
+    // JSON fails with the single error "Parse error".
+    bool validateJSON(const char *raw, size_t size, std::vector<std::string>& errors) const;
+    bool validateJSON(const std::string& raw, std::vector<std::string>& errors) const {
+        return validateJSON(raw.data(), raw.size(), errors);
+    }
+
+private:
+    struct Member {
+        std::string key;
+        UniValue::VType type;
+        bool isRequired;
+        bool hasRange;
+        int64_t minVal, maxVal;
+        bool hasLength;
+        size_t minLen, maxLen;
+        std::shared_ptr<const UniValueSchema> schema;
+    };
+
+    UnknownKeys unknown;
+    std::vector<Member> members;
+    std::vector<size_t> sorted;     // member indices, ordered by key
+    size_t last = 0;                // target of the constraint setters
+
+    friend class UniValueSchemaHandler;
+
+    UniValueSchema& add(std::string_view key, UniValue::VType type, bool isRequired);
+    const Member *lookup(std::string_view key, size_t& index) const;
+    bool checkValue(const Member& m, UniValue::VType type, const std::string& text,
+                    const std::string& path, std::vector<std::string>& errors) const;
+    void checkMissing(const std::vector<bool>& seen, const std::string& path,
+                      std::vector<std::string>& errors) const;
+    void validateObject(const UniValue& val, const std::string& path,
+                        std::vector<std::string>& errors) const;
+};
+
+#endif // __UNIVALUE_SCHEMA_H__
@@ -0,0 +1,124 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_STREAM_H__
+#define __UNIVALUE_STREAM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "univalue.h"
+
+/**
+ * Destination for serialized output.  Writers buffer internally and hand
+ * data to the sink in large blocks.
+ */
+class UniValueSink {
+public:
+    virtual ~UniValueSink() {}
+    virtual bool write(const char *data, size_t len) = 0;
+    virtual bool flush() { return true; }
+};
+
+class UniValueStringSink : public UniValueSink {
+public:
+    explicit UniValueStringSink(std::string& s) : str(s) {}
+    bool write(const char *data, size_t len) { str.append(data, len); return true; }
+
+private:
+    std::string& str;
+};
+
+class UniValueFileSink : public UniValueSink {
+public:
+    explicit UniValueFileSink(FILE *f) : file(f) {}
+    bool write(const char *data, size_t len) { return fwrite(data, 1, len, file) == len; }
+    bool flush() { return fflush(file) == 0; }
+
+private:
+    FILE *file;
+};
+
+/**
+ * Writes JSON to a sink as it is produced, without building a UniValue
+ * tree first.  Memory use is proportional to nesting depth.  The output is
+ * byte-identical to building the same tree and calling
+ * UniValue::write(prettyIndent, indentLevel).
+ *
+ * Each call returns false if it would make the document malformed (a key
+ * outside an object, a value where a key is expected, unbalanced end*()
+ * calls, a second top-level value) or if the sink fails; the writer then
+ * stays in the failed state.
+ */
+class UniValueWriter {
+public:
+    UniValueWriter(UniValueSink& sink, unsigned int prettyIndent = 0,
+                   unsigned int indentLevel = 0);
+    ~UniValueWriter();
+
+    bool beginObject();
+    bool endObject();
+    bool beginArray();
+    bool endArray();
+    bool key(std::string_view k);
+
+    bool value(const UniValue& val);       // a whole subtree
+    bool valueNull();
+    bool value(bool val);
+    bool value(int val) { return value((int64_t)val); }
+    bool value(int64_t val);
+    bool value(uint64_t val);
+    bool value(double val);
+    bool value(std::string_view val);
+    bool value(const std::string& val) { return value(std::string_view(val)); }
+    bool value(const char *val) { return value(std::string_view(val)); }
+    bool valueNumStr(const std::string& val);
+    // Binary data as a string of lowercase hex digits
+    bool valueHex(const uint8_t *data, size_t size);
+
+    // Convenience for key() followed by value()
+    template <typename T>
+    bool pushKV(std::string_view k, const T& val) { return key(k) && value(val); }
+
+    // Push buffered output to the sink
+    bool flush();
+    // Flush, and check that exactly one complete top-level value was written
+    bool finish();
+
+    bool failed() const { return error; }
+    size_t depth() const { return stack.size(); }
+
+private:
+    struct Frame {
+        bool isObject;
+        bool haveKey;
+        size_t count;
+    };
+
+    UniValueSink& sink;
+    unsigned int prettyIndent;
+    unsigned int indentLevel;
+    unsigned int modIndent;
+    std::vector<Frame> stack;
+    std::string buf;
+    bool done;
+    bool error;
+
+    bool beginValue();
+    bool endValue();
+    bool beginContainer(bool isObject);
+    bool endContainer(bool isObject);
+    bool writeScalar(const std::string& text);
+    void indent(unsigned int n) { buf.append(prettyIndent * n, ' '); }
+    bool fail() { error = true; return false; }
+
+    UniValueWriter(const UniValueWriter&);
+    UniValueWriter& operator=(const UniValueWriter&);
+};
+
+#endif // __UNIVALUE_STREAM_H__
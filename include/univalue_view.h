@@ -0,0 +1,85 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef __UNIVALUE_VIEW_H__
+#define __UNIVALUE_VIEW_H__
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "univalue.h"
+
+/**
+ * Read-only view into a snapshot produced by UniValue::writeSnapshot().
+ *
+ * A snapshot is position independent, so it can be written to disk and
+ * mmap()ed back, then queried in place without being parsed or copied.
+ * A view is three words and is passed by value; it does not own the
+ * buffer, which must outlive every view into it.
+ *
+ * Every access is bounds checked against the buffer, so a truncated or
+ * corrupt snapshot yields null views rather than out-of-range reads.
+ * Strict getters throw std::runtime_error exactly like UniValue's.
+ *
+ * Looking up an object member by key compares the keys in order, so it is
+ * O(n) in the size of the object; convert with toUniValue() first when
+ * looking up many keys of a large object.
+ */
+class UniValueView {
+public:
+    UniValueView() : base(NULL), len(0), off(0) {}
+
+    // Attach to the root of a snapshot; false if data is not a snapshot
+    static bool open(const void *data, size_t len, UniValueView& root);
+
+    UniValue::VType getType() const;
+    bool isNull() const { return getType() == UniValue::VNULL; }
+    bool isTrue() const;
+    bool isFalse() const { return isBool() && !isTrue(); }
+    bool isBool() const { return getType() == UniValue::VBOOL; }
+    bool isStr() const { return getType() == UniValue::VSTR; }
+    bool isNum() const { return getType() == UniValue::VNUM; }
+    bool isArray() const { return getType() == UniValue::VARR; }
+    bool isObject() const { return getType() == UniValue::VOBJ; }
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    UniValueView operator[](size_t index) const;
+    UniValueView operator[](std::string_view key) const;
+    bool exists(std::string_view key) const;
+    std::string_view key(size_t index) const;
+
+    // Text of a string or number; empty for other types
+    std::string_view getValStr() const;
+
+    bool get_bool() const;
+    std::string_view get_str() const;
+    int get_int() const;
+    int64_t get_int64() const;
+    double get_real() const;
+
+    // Copy the subtree into a mutable UniValue; false if the snapshot is
+    // corrupt below this point, including when nodes are shared so that
+    // the copy would be larger than the snapshot could hold
+    bool toUniValue(UniValue& val) const;
+
+private:
+    const unsigned char *base;
+    size_t len;
+    uint32_t off;
+
+    UniValueView(const unsigned char *base_, size_t len_, uint32_t off_)
+        : base(base_), len(len_), off(off_) {}
+
+    bool readU32(size_t pos, uint32_t& n) const;
+    bool tag(UniValue::VType& type, uint32_t& n) const;
+    bool text(const char *& str, uint32_t& n) const;
+    UniValueView child(size_t pos) const;
+    bool toUniValue(UniValue& val, unsigned int depth, size_t& budget) const;
+};
+
+#endif // __UNIVALUE_VIEW_H__
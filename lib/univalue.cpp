@@ -4,20 +4,77 @@
 // file COPYING or https://opensource.org/licenses/mit-license.php.
 
 #include <stdint.h>
+#include <charconv>
 #include <iomanip>
 #include <sstream>
 #include <stdlib.h>
+#include <stdio.h>
+#include <iterator>
+#include <utility>
 
 #include "univalue.h"
+#include "univalue_format.h"
+#include "univalue_instrument.h"
+#include "univalue_kernels.h"
 
 const UniValue NullUniValue;
 
+UniValue::UniValue(const UniValue& other)
+    : typ(other.typ), val(other.val), keys(other.keys), values(other.values)
+{
+    // a copy's capacities are not the original's, so count them afresh
+    updateUsage();
+    UV_COUNT(copies, 1);
+    UV_COUNT(copyBytes, other.memUsage);
+}
+
+UniValue& UniValue::operator=(const UniValue& other)
+{
+    if (this != &other) {
+        typ = other.typ;
+        val = other.val;
+        keys = other.keys;
+        values = other.values;
+        updateUsage();
+        UV_COUNT(copies, 1);
+        UV_COUNT(copyBytes, other.memUsage);
+    }
+    return *this;
+}
+
+UniValue& UniValue::operator=(UniValue&& other) noexcept
+{
+    if (this != &other) {
+        // The vectors always take over other's storage, but a short val
+        // is copied into whatever storage val already had
+        size_t otherUsage = other.memUsage - stringUsage(other.val);
+        typ = other.typ;
+        val = std::move(other.val);
+        keys = std::move(other.keys);
+        values = std::move(other.values);
+        memUsage = otherUsage + stringUsage(val);
+        other.memUsage = other.shallowUsage();
+    }
+    return *this;
+}
+
+// Recount this node from its direct children, whose counts are current
+void UniValue::updateUsage()
+{
+    memUsage = shallowUsage();
+    for (size_t i = 0; i < keys.size(); i++)
+        memUsage += stringUsage(keys[i]);
+    for (size_t i = 0; i < values.size(); i++)
+        memUsage += values[i].memUsage;
+}
+
 void UniValue::clear()
 {
     typ = VNULL;
     val.clear();
     keys.clear();
     values.clear();
+    memUsage = shallowUsage();
 }
 
 bool UniValue::setNull()
@@ -32,6 +89,7 @@ bool UniValue::setBool(bool val_)
     typ = VBOOL;
     if (val_)
         val = "1";
+    memUsage = shallowUsage();
     return true;
 }
 
@@ -51,34 +109,110 @@ bool UniValue::setNumStr(const std::string& val_)
     clear();
     typ = VNUM;
     val = val_;
+    memUsage = shallowUsage();
     return true;
 }
 
-bool UniValue::setInt(uint64_t val_)
+std::string json_format_uint(uint64_t n)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    char buf[20];
+    char *p = buf + sizeof(buf);
+    do {
+        *--p = '0' + (n % 10);
+        n /= 10;
+    } while (n);
+
+    return std::string(p, buf + sizeof(buf));
+}
 
-    return setNumStr(oss.str());
+std::string json_format_int(int64_t n)
+{
+    if (n >= 0)
+        return json_format_uint((uint64_t)n);
+    return "-" + json_format_uint(0 - (uint64_t)n);
 }
 
-bool UniValue::setInt(int64_t val_)
+// Numbers are formatted and parsed without the C locale: it may not use
+// '.', and querying it is not thread-safe, while writeParallel() and
+// processJsonBatch() format numbers on worker threads.
+std::string json_format_float(double n)
 {
+#ifdef __cpp_lib_to_chars
+    char buf[32];
+    std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), n,
+                                             std::chars_format::general, 16);
+    if (res.ec == std::errc())
+        return std::string(buf, res.ptr);
+#endif
+
     std::ostringstream oss;
+    oss.imbue(std::locale::classic());
 
-    oss << val_;
+    oss << std::setprecision(16) << n;
 
-    return setNumStr(oss.str());
+    return oss.str();
 }
 
-bool UniValue::setFloat(double val_)
+json_num_kind json_classify_number(const std::string& s, int64_t& i, uint64_t& u, double& d)
 {
-    std::ostringstream oss;
+    size_t pos = 0;
+    bool negative = (!s.empty() && s[0] == '-');
+    if (negative)
+        pos++;
+
+    // plain integers: no leading zeros, no "-0", no overflow
+    bool isInt = (pos < s.size()) && (s[pos] != '0' || s.size() == pos + 1) &&
+                 !(negative && s[pos] == '0');
+    uint64_t mag = 0;
+    for (size_t p = pos; isInt && p < s.size(); p++) {
+        unsigned int digit = (unsigned char)s[p] - '0';
+        if (digit > 9 || mag > (UINT64_MAX - digit) / 10)
+            isInt = false;
+        else
+            mag = mag * 10 + digit;
+    }
+    if (isInt) {
+        if (!negative && mag <= (uint64_t)INT64_MAX) {
+            i = (int64_t)mag;
+            return JNUM_INT;
+        } else if (!negative) {
+            u = mag;
+            return JNUM_UINT;
+        } else if (mag <= (uint64_t)INT64_MAX + 1) {
+            i = (int64_t)(0 - mag);
+            return JNUM_INT;
+        }
+    }
+
+#ifdef __cpp_lib_to_chars
+    std::from_chars_result res = std::from_chars(s.data(), s.data() + s.size(), d);
+    if (res.ec != std::errc() || res.ptr != s.data() + s.size())
+        return JNUM_TEXT;
+#else
+    std::istringstream text(s);
+    text.imbue(std::locale::classic());
+    text >> d;
+    if (text.fail() || !text.eof())
+        return JNUM_TEXT;
+#endif
+    if (json_format_float(d) != s)
+        return JNUM_TEXT;
+    return JNUM_DOUBLE;
+}
+
+bool UniValue::setInt(uint64_t val_)
+{
+    return setNumStr(json_format_uint(val_));
+}
 
-    oss << std::setprecision(16) << val_;
+bool UniValue::setInt(int64_t val_)
+{
+    return setNumStr(json_format_int(val_));
+}
 
-    bool ret = setNumStr(oss.str());
+bool UniValue::setFloat(double val_)
+{
+    bool ret = setNumStr(json_format_float(val_));
     typ = VNUM;
     return ret;
 }
@@ -88,6 +222,17 @@ bool UniValue::setStr(const std::string& val_)
     clear();
     typ = VSTR;
     val = val_;
+    memUsage = shallowUsage();
+    return true;
+}
+
+bool UniValue::setHex(const uint8_t *data, size_t size)
+{
+    clear();
+    typ = VSTR;
+    val.resize(2 * size);
+    json_hex_encode(data, size, &val[0]);
+    memUsage = shallowUsage();
     return true;
 }
 
@@ -110,7 +255,20 @@ bool UniValue::push_back(const UniValue& val_)
     if (typ != VARR)
         return false;
 
+    size_t before = shallowUsage();
     values.push_back(val_);
+    memUsage += shallowUsage() - before + values.back().memUsage;
+    return true;
+}
+
+bool UniValue::push_back(UniValue&& val_)
+{
+    if (typ != VARR)
+        return false;
+
+    size_t before = shallowUsage();
+    values.push_back(std::move(val_));
+    memUsage += shallowUsage() - before + values.back().memUsage;
     return true;
 }
 
@@ -119,26 +277,59 @@ bool UniValue::push_backV(const std::vector<UniValue>& vec)
     if (typ != VARR)
         return false;
 
+    size_t before = shallowUsage();
     values.insert(values.end(), vec.begin(), vec.end());
+    memUsage += shallowUsage() - before;
+    for (size_t i = values.size() - vec.size(); i < values.size(); i++)
+        memUsage += values[i].memUsage;
 
     return true;
 }
 
-void UniValue::__pushKV(const std::string& key, const UniValue& val_)
+void UniValue::__pushKV(std::string_view key, const UniValue& val_)
 {
-    keys.push_back(key);
+    size_t before = shallowUsage();
+    keys.emplace_back(key);
+    val.push_back((char)keyTag(key));
     values.push_back(val_);
+    memUsage += shallowUsage() - before + stringUsage(keys.back()) + values.back().memUsage;
+}
+
+void UniValue::__pushKV(std::string_view key, UniValue&& val_)
+{
+    size_t before = shallowUsage();
+    keys.emplace_back(key);
+    val.push_back((char)keyTag(key));
+    values.push_back(std::move(val_));
+    memUsage += shallowUsage() - before + stringUsage(keys.back()) + values.back().memUsage;
+}
+
+bool UniValue::pushKV(std::string_view key, UniValue&& val_)
+{
+    if (typ != VOBJ)
+        return false;
+
+    size_t idx;
+    if (findKey(key, idx)) {
+        size_t before = values[idx].memUsage;
+        values[idx] = std::move(val_);
+        memUsage += values[idx].memUsage - before;
+    } else
+        __pushKV(key, std::move(val_));
+    return true;
 }
 
-bool UniValue::pushKV(const std::string& key, const UniValue& val_)
+bool UniValue::pushKV(std::string_view key, const UniValue& val_)
 {
     if (typ != VOBJ)
         return false;
 
     size_t idx;
-    if (findKey(key, idx))
+    if (findKey(key, idx)) {
+        size_t before = values[idx].memUsage;
         values[idx] = val_;
-    else
+        memUsage += values[idx].memUsage - before;
+    } else
         __pushKV(key, val_);
     return true;
 }
@@ -154,6 +345,39 @@ bool UniValue::pushKVs(const UniValue& obj)
     return true;
 }
 
+std::shared_ptr<const UniValue> UniValue::freeze() const &
+{
+    return std::make_shared<const UniValue>(*this);
+}
+
+std::shared_ptr<const UniValue> UniValue::freeze() &&
+{
+    return std::make_shared<const UniValue>(std::move(*this));
+}
+
+void UniValue::compactString(std::string& s)
+{
+    // shrink_to_fit() is only a request; a copy is always exact
+    if (s.capacity() > s.size() && s.capacity() > std::string().capacity())
+        std::string(s).swap(s);
+}
+
+void UniValue::compact()
+{
+    compactString(val);
+    for (size_t i = 0; i < keys.size(); i++)
+        compactString(keys[i]);
+    for (size_t i = 0; i < values.size(); i++)
+        values[i].compact();
+    if (keys.capacity() > keys.size())
+        std::vector<std::string>(std::make_move_iterator(keys.begin()),
+                                 std::make_move_iterator(keys.end())).swap(keys);
+    if (values.capacity() > values.size())
+        std::vector<UniValue>(std::make_move_iterator(values.begin()),
+                              std::make_move_iterator(values.end())).swap(values);
+    updateUsage();
+}
+
 void UniValue::getObjMap(std::map<std::string,UniValue>& kv) const
 {
     if (typ != VOBJ)
@@ -164,9 +388,41 @@ void UniValue::getObjMap(std::map<std::string,UniValue>& kv) const
         kv[keys[i]] = values[i];
 }
 
-bool UniValue::findKey(const std::string& key, size_t& retIdx) const
+void UniValue::getObjMap(std::map<std::string_view,const UniValue*>& kv) const
 {
-    for (size_t i = 0; i < keys.size(); i++) {
+    if (typ != VOBJ)
+        return;
+
+    kv.clear();
+    for (size_t i = 0; i < keys.size(); i++)
+        kv[keys[i]] = &values[i];
+}
+
+bool UniValue::findKey(std::string_view key, size_t& retIdx) const
+{
+    UV_COUNT(findKeyCalls, 1);
+
+    // A few keys are quicker to compare than to compute a tag for
+    const size_t n = keys.size();
+    if (n < 8) {
+        for (size_t i = 0; i < n; i++) {
+            UV_COUNT(findKeyProbes, 1);
+            if (keys[i] == key) {
+                retIdx = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Otherwise scan the tags (see keyTag()) for the key's, and only look
+    // at the keys whose tag matches
+    const unsigned char tag = keyTag(key);
+    const char *tags = val.data();
+    const UniValueKernels& kernels = uvKernels();
+    for (size_t i = kernels.byteRun(tags, n, tag); i < n;
+         i += 1 + kernels.byteRun(tags + i + 1, n - i - 1, tag)) {
+        UV_COUNT(findKeyProbes, 1);
         if (keys[i] == key) {
             retIdx = i;
             return true;
@@ -194,7 +450,7 @@ bool UniValue::checkObject(const std::map<std::string,UniValue::VType>& t) const
     return true;
 }
 
-const UniValue& UniValue::operator[](const std::string& key) const
+const UniValue& UniValue::operator[](std::string_view key) const
 {
     if (typ != VOBJ)
         return NullUniValue;
@@ -231,11 +487,11 @@ const char *uvTypeName(UniValue::VType t)
     return NULL;
 }
 
-const UniValue& find_value(const UniValue& obj, const std::string& name)
+const UniValue& find_value(const UniValue& obj, std::string_view name)
 {
-    for (unsigned int i = 0; i < obj.keys.size(); i++)
-        if (obj.keys[i] == name)
-            return obj.values.at(i);
+    size_t i;
+    if (obj.findKey(name, i))
+        return obj.values.at(i);
 
     return NullUniValue;
 }
@@ -0,0 +1,310 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "univalue.h"
+#include "univalue_batch.h"
+#include "univalue_stream.h"
+
+struct BatchSpan {
+    const char *begin;
+    const char *end;
+};
+
+// Find the top-level elements of an array by tracking brackets and
+// strings only.  Anything the scan lets through that is not valid JSON is
+// caught when the elements are parsed.
+static bool scanBatch(const char *raw, const char *end, std::vector<BatchSpan>& spans)
+{
+    while (raw < end && json_isspace(*raw))
+        raw++;
+    if (raw >= end || *raw != '[')
+        return false;
+    raw++;
+
+    const char *start = raw;
+    size_t depth = 0;
+    bool any = false;               // non-space seen in the current element
+    for (; raw < end; raw++) {
+        char ch = *raw;
+        if (ch == '"') {
+            for (raw++; raw < end && *raw != '"'; raw++) {
+                if (*raw == '\\')
+                    raw++;
+            }
+            if (raw >= end)
+                return false;
+            any = true;
+        } else if (ch == '[' || ch == '{') {
+            depth++;
+            any = true;
+        } else if (ch == ']' || ch == '}') {
+            if (depth == 0) {
+                if (ch != ']')
+                    return false;
+                if (any)
+                    spans.push_back(BatchSpan{start, raw});
+                else if (!spans.empty())
+                    return false;               // [1,]
+                break;
+            }
+            depth--;
+        } else if (ch == ',' && depth == 0) {
+            if (!any)
+                return false;                   // [,1] or [1,,2]
+            spans.push_back(BatchSpan{start, raw});
+            start = raw + 1;
+            any = false;
+        } else if (!json_isspace(ch)) {
+            any = true;
+        }
+    }
+    if (raw >= end)
+        return false;
+
+    // nothing but whitespace may follow the array
+    for (raw++; raw < end; raw++) {
+        if (!json_isspace(*raw))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Worker threads kept for the life of the process, so that a batch does
+ * not pay for starting threads.  A caller posts a job and works on it
+ * itself; idle pool threads join in to help, up to the number the job
+ * asks for.  Since the caller can finish a job alone, one that finds the
+ * pool busy, e.g. a handler that processes a nested batch, still
+ * completes.
+ */
+class BatchPool {
+public:
+    struct Job {
+        std::function<void(unsigned int)> work;    // called with a slot number
+        unsigned int wanted;                        // helpers still wanted
+        unsigned int nextSlot = 1;                  // slot 0 is the caller's
+        unsigned int active = 0;                    // helpers working on it
+    };
+
+    ~BatchPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            shutdown = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+
+    // Run work(0) here, and work(1) ... work(helpers) on whichever pool
+    // threads are free to take them
+    void run(unsigned int helpers, const std::function<void(unsigned int)>& work)
+    {
+        Job job;
+        job.work = work;
+        job.wanted = helpers;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            grow(helpers);
+            jobs.push_back(&job);
+        }
+        wake.notify_all();
+
+        std::exception_ptr error;
+        try {
+            work(0);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // take the job down, then wait for the helpers that picked it up
+        std::unique_lock<std::mutex> guard(lock);
+        jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+        done.wait(guard, [&job] { return job.active == 0; });
+        guard.unlock();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable wake;               // a job was posted, or shutdown
+    std::condition_variable done;               // a helper left its job
+    std::vector<std::thread> threads;
+    std::vector<Job*> jobs;                     // posted, until their callers finish
+    bool shutdown = false;
+
+    // Have at least n threads.  If the system runs out of threads, the
+    // callers do the work with the ones there are.
+    void grow(size_t n)
+    {
+        try {
+            while (threads.size() < n)
+                threads.emplace_back(&BatchPool::helper, this);
+        } catch (const std::system_error&) {
+        }
+    }
+
+    void helper()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            Job *job = NULL;
+            for (size_t i = 0; i < jobs.size() && !job; i++) {
+                if (jobs[i]->wanted)
+                    job = jobs[i];
+            }
+            if (!job) {
+                if (shutdown)
+                    return;
+                wake.wait(guard);
+                continue;
+            }
+
+            unsigned int slot = job->nextSlot++;
+            job->wanted--;
+            job->active++;
+            guard.unlock();
+            job->work(slot);                    // does not throw, see runPool()
+            guard.lock();
+            if (--job->active == 0)
+                done.notify_all();
+        }
+    }
+};
+
+static BatchPool& batchPool()
+{
+    static BatchPool pool;
+    return pool;
+}
+
+/**
+ * Runs task(0) ... task(n - 1) on up to nThreads workers, the calling
+ * thread being one of them.  Each worker starts with an equal, contiguous
+ * share of the indices and takes them from the front; once its own share
+ * is exhausted it steals from the back of the others', so slow tasks do
+ * not hold up the rest, and shares no worker arrives for are stolen too.
+ * Stops early, and rethrows, if a task throws.
+ */
+static void runPool(size_t n, unsigned int nThreads, const std::function<void(size_t)>& task)
+{
+    if (nThreads > n)
+        nThreads = (unsigned int)n;
+    if (nThreads <= 1) {
+        for (size_t i = 0; i < n; i++)
+            task(i);
+        return;
+    }
+
+    struct Queue {
+        std::mutex lock;
+        size_t front, back;
+    };
+    std::vector<Queue> queues(nThreads);
+    for (unsigned int w = 0; w < nThreads; w++) {
+        queues[w].front = n * w / nThreads;
+        queues[w].back = n * (w + 1) / nThreads;
+    }
+
+    std::atomic<bool> stop(false);
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    auto worker = [&](unsigned int self) {
+        while (!stop) {
+            size_t index = n;
+            {
+                std::lock_guard<std::mutex> guard(queues[self].lock);
+                if (queues[self].front < queues[self].back)
+                    index = queues[self].front++;
+            }
+            for (unsigned int w = 1; index == n && w < nThreads; w++) {
+                Queue& victim = queues[(self + w) % nThreads];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.front < victim.back)
+                    index = --victim.back;
+            }
+            if (index == n)
+                return;
+
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+            }
+        }
+    };
+
+    batchPool().run(nThreads - 1, worker);
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool processJsonBatch(const char *raw, size_t size, const UniValueBatchHandler& handler,
+                      UniValueWriter& out, unsigned int nThreads)
+{
+    std::vector<BatchSpan> spans;
+    if (!scanBatch(raw, raw + size, spans))
+        return false;
+
+    // JSON-RPC 2.0 answers an empty batch with a single error, not an
+    // empty array
+    if (spans.empty()) {
+        UniValue error(UniValue::VOBJ);
+        error.pushKV("code", -32600);
+        error.pushKV("message", "Invalid Request");
+        UniValue reply(UniValue::VOBJ);
+        reply.pushKV("jsonrpc", "2.0");
+        reply.pushKV("error", error);
+        reply.pushKV("id", NullUniValue);
+        return out.value(reply);
+    }
+
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+
+    // Parse everything before handling anything, so that a malformed
+    // batch has no side effects
+    std::vector<UniValue> requests(spans.size());
+    std::atomic<bool> valid(true);
+    runPool(spans.size(), nThreads, [&](size_t i) {
+        if (!requests[i].read(spans[i].begin, spans[i].end - spans[i].begin))
+            valid = false;
+    });
+    if (!valid)
+        return false;
+
+    std::vector<UniValue> replies(spans.size());
+    std::vector<char> haveReply(spans.size(), 0);
+    runPool(spans.size(), nThreads, [&](size_t i) {
+        haveReply[i] = handler(requests[i], replies[i]);
+    });
+
+    bool started = false;
+    for (size_t i = 0; i < replies.size(); i++) {
+        if (!haveReply[i])
+            continue;
+        if (!started && !out.beginArray())
+            return false;
+        started = true;
+        if (!out.value(replies[i]))
+            return false;
+    }
+    return !started || out.endArray();
+}
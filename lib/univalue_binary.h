@@ -0,0 +1,93 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+#ifndef UNIVALUE_BINARY_H
+#define UNIVALUE_BINARY_H
+
+#include <stdint.h>
+#include <string>
+#include "univalue_stream.h"
+
+/**
+ * Byte-level plumbing shared by the binary encodings (CBOR, MessagePack).
+ */
+
+// Encoders buffer output and hand it to the sink in blocks of this size
+static const size_t BINARY_FLUSH_SIZE = 64 * 1024;
+
+class BinaryWriter
+{
+public:
+    // Without a sink, output accumulates in buf
+    explicit BinaryWriter(UniValueSink *sink_) : sink(sink_), ok(true) {}
+
+    std::string buf;
+
+    void put(unsigned char ch) { buf += (char)ch; }
+    void putBE(uint64_t n, unsigned int bytes)
+    {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8)
+            buf += (char)((n >> shift) & 0xff);
+    }
+    void maybeFlush()
+    {
+        if (sink && buf.size() >= BINARY_FLUSH_SIZE)
+            flush();
+    }
+    bool flush()
+    {
+        if (!sink)
+            return ok;
+        if (!buf.empty() && !sink->write(buf.data(), buf.size()))
+            ok = false;
+        buf.clear();
+        if (!sink->flush())
+            ok = false;
+        return ok;
+    }
+    bool good() const { return ok; }
+
+private:
+    UniValueSink *sink;
+    bool ok;
+};
+
+class BinaryReader
+{
+public:
+    BinaryReader(const unsigned char *data, size_t len)
+        : p(data), end(data + len) {}
+
+    bool atEnd() const { return p == end; }
+    size_t remaining() const { return end - p; }
+    bool getByte(unsigned char& ch)
+    {
+        if (p >= end)
+            return false;
+        ch = *p++;
+        return true;
+    }
+    bool getBE(unsigned int bytes, uint64_t& n)
+    {
+        if (remaining() < bytes)
+            return false;
+        n = 0;
+        for (unsigned int i = 0; i < bytes; i++)
+            n = (n << 8) | *p++;
+        return true;
+    }
+    bool getBytes(uint64_t len, std::string& s)
+    {
+        if (len > remaining())
+            return false;
+        s.append((const char *)p, len);
+        p += len;
+        return true;
+    }
+
+protected:
+    const unsigned char *p;
+    const unsigned char *end;
+};
+
+#endif
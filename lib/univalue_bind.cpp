@@ -0,0 +1,220 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "univalue.h"
+#include "univalue_bind.h"
+#include "univalue_sax.h"
+#include "univalue_format.h"
+
+static const char *valueBool(void *dst, UniValue::VType type, const std::string& text,
+                             void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    if (type != UniValue::VBOOL)
+        return univalue_codec_bool.expected;
+    *static_cast<bool *>(dst) = (text == "1");
+    return NULL;
+}
+
+static const char *valueInt(void *dst, UniValue::VType type, const std::string& text,
+                            void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    if (type != UniValue::VNUM)
+        return univalue_codec_int.expected;
+    int32_t n;
+    if (!json_parse_int32(text.c_str(), text.size(), &n))
+        return "JSON integer out of range";
+    *static_cast<int *>(dst) = n;
+    return NULL;
+}
+
+static const char *valueInt64(void *dst, UniValue::VType type, const std::string& text,
+                              void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    if (type != UniValue::VNUM)
+        return univalue_codec_int64.expected;
+    int64_t n;
+    if (!json_parse_int64(text.c_str(), text.size(), &n))
+        return "JSON integer out of range";
+    *static_cast<int64_t *>(dst) = n;
+    return NULL;
+}
+
+static const char *valueReal(void *dst, UniValue::VType type, const std::string& text,
+                             void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    if (type != UniValue::VNUM)
+        return univalue_codec_real.expected;
+    double d;
+    if (!json_parse_double(text.c_str(), text.size(), &d))
+        return "JSON double out of range";
+    *static_cast<double *>(dst) = d;
+    return NULL;
+}
+
+static const char *valueStr(void *dst, UniValue::VType type, const std::string& text,
+                            void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    if (type != UniValue::VSTR)
+        return univalue_codec_str.expected;
+    *static_cast<std::string *>(dst) = text;
+    return NULL;
+}
+
+static const char *valueBytes(void *dst, UniValue::VType type, const std::string& text,
+                              void *& /* child */, const UniValueCodec *& /* childCodec */)
+{
+    std::vector<unsigned char>& bytes = *static_cast<std::vector<unsigned char> *>(dst);
+    if (type != UniValue::VSTR || text.size() % 2)
+        return univalue_codec_bytes.expected;
+    bytes.resize(text.size() / 2);
+    if (!json_hex_decode(text.data(), bytes.size(), bytes.data()))
+        return univalue_codec_bytes.expected;
+    return NULL;
+}
+
+static std::vector<unsigned char> *bytesBuffer(void *dst)
+{
+    return static_cast<std::vector<unsigned char> *>(dst);
+}
+
+const UniValueCodec univalue_codec_bool = {
+    "JSON value is not a boolean as expected", false, valueBool, NULL, NULL, NULL, NULL
+};
+const UniValueCodec univalue_codec_int = {
+    "JSON value is not an integer as expected", false, valueInt, NULL, NULL, NULL, NULL
+};
+const UniValueCodec univalue_codec_int64 = {
+    "JSON value is not an integer as expected", false, valueInt64, NULL, NULL, NULL, NULL
+};
+const UniValueCodec univalue_codec_real = {
+    "JSON value is not a number as expected", false, valueReal, NULL, NULL, NULL, NULL
+};
+const UniValueCodec univalue_codec_str = {
+    "JSON value is not a string as expected", false, valueStr, NULL, NULL, NULL, NULL
+};
+const UniValueCodec univalue_codec_bytes = {
+    "JSON value is not a hex string as expected", false, valueBytes, NULL, NULL, NULL, bytesBuffer
+};
+
+/**
+ * Feeds parser events to the codecs.  Each open struct or vector has a
+ * frame; members that are not bound are skipped by the parser.
+ */
+class UniValueDecodeHandler : public UniValueSAXHandler {
+public:
+    UniValueDecodeHandler(void *out, const UniValueCodec& codec, std::string& error_)
+        : rootObj(out), rootCodec(&codec), error(error_) {}
+
+    Action onNull() override { return value(UniValue::VNULL, ""); }
+    Action onBool(bool val) override { return value(UniValue::VBOOL, val ? "1" : ""); }
+    Action onNumber(const std::string& text) override { return value(UniValue::VNUM, text); }
+    Action onString(const std::string& str) override { return value(UniValue::VSTR, str); }
+    Action onHex(const std::vector<unsigned char>& /* bytes */) override {
+        // already decoded in place by hexBuffer()'s codec
+        pendingCodec = NULL;
+        return SAX_OK;
+    }
+
+    std::vector<unsigned char> *hexBuffer() override {
+        pendingDst = target(pendingCodec);
+        return pendingCodec->bytes ? pendingCodec->bytes(pendingDst) : NULL;
+    }
+    Action onBeginObject() override { return value(UniValue::VOBJ, ""); }
+    Action onBeginArray() override { return value(UniValue::VARR, ""); }
+
+    Action onKey(const std::string& key) override {
+        Frame& top = stack.back();
+        size_t index;
+        top.member = top.codec->field(top.obj, key, top.memberCodec, index);
+        if (!top.member || (top.seen & (1ULL << index)))
+            return SAX_SKIP;
+        top.seen |= (1ULL << index);
+        return SAX_OK;
+    }
+
+    Action onEndObject() override {
+        const char *err = stack.back().codec->finish(stack.back().seen);
+        stack.pop_back();
+        return err ? fail(err) : SAX_OK;
+    }
+
+    Action onEndArray() override {
+        stack.pop_back();
+        return SAX_OK;
+    }
+
+private:
+    struct Frame {
+        void *obj;
+        const UniValueCodec *codec;
+        uint64_t seen;                          // struct: members found
+        void *member;                           // struct: current member
+        const UniValueCodec *memberCodec;
+    };
+
+    void *rootObj;
+    const UniValueCodec *rootCodec;
+    std::string& error;
+    std::vector<Frame> stack;
+    // set by hexBuffer() for the value that follows
+    void *pendingDst = NULL;
+    const UniValueCodec *pendingCodec = NULL;
+
+    Action fail(const char *err) {
+        error = err;
+        return SAX_STOP;
+    }
+
+    // Where the next value goes, appending an element to a vector
+    void *target(const UniValueCodec *& codec) {
+        if (stack.empty()) {
+            codec = rootCodec;
+            return rootObj;
+        }
+        Frame& top = stack.back();
+        if (top.codec->element)
+            return top.codec->element(top.obj, codec);
+        codec = top.memberCodec;
+        return top.member;
+    }
+
+    Action value(UniValue::VType type, const std::string& text) {
+        void *dst;
+        const UniValueCodec *codec = pendingCodec;
+        if (codec) {
+            dst = pendingDst;
+            pendingCodec = NULL;
+        } else {
+            dst = target(codec);
+        }
+
+        void *child = NULL;
+        const UniValueCodec *childCodec = NULL;
+        const char *err = codec->value(dst, type, text, child, childCodec);
+        if (err)
+            return fail(err);
+
+        if (type == UniValue::VOBJ || type == UniValue::VARR) {
+            Frame f = { child, childCodec, 0, NULL, NULL };
+            stack.push_back(f);
+        }
+        return SAX_OK;
+    }
+};
+
+bool decodeJSON(const char *raw, size_t size, void *out, const UniValueCodec& codec,
+                std::string& error)
+{
+    error.clear();
+    UniValueDecodeHandler handler(out, codec, error);
+    if (!readJsonSAX(raw, size, handler)) {
+        if (error.empty())
+            error = "JSON parse error";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,402 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "univalue.h"
+#include "univalue_stream.h"
+#include "univalue_format.h"
+#include "univalue_binary.h"
+#include "univalue_utffilter.h"
+
+/*
+ * CBOR (RFC 8949) mapping:
+ *
+ *   VNULL  <-> simple value 22 (null); 23 (undefined) also decodes as null
+ *   VBOOL  <-> simple values 20/21
+ *   VSTR   <-> text string (major 3); strings that are not valid UTF-8 are
+ *              written as byte strings (major 2), which decode as VSTR
+ *   VARR   <-> array (major 4)
+ *   VOBJ   <-> map (major 5) with text string keys, in insertion order;
+ *              keys that are not valid UTF-8 are written as byte strings
+ *   VNUM   <-> unsigned/negative integer (major 0/1) if the text is a plain
+ *              integer in the 64-bit range; float (major 7) if the text is
+ *              exactly what setFloat() would produce for that double;
+ *              otherwise tag 262 (embedded JSON) around the number text.
+ *
+ * Every encoding is definite-length.  The decoder also accepts
+ * indefinite-length strings, arrays and maps, and half-precision floats.
+ * Tags other than 262 are ignored and their content decoded as usual.
+ */
+
+static const size_t MAX_CBOR_DEPTH = 512;     // same limit as read()
+
+enum cbor_major {
+    CBOR_UINT = 0,
+    CBOR_NEGINT = 1,
+    CBOR_BYTES = 2,
+    CBOR_TEXT = 3,
+    CBOR_ARRAY = 4,
+    CBOR_MAP = 5,
+    CBOR_TAG = 6,
+    CBOR_SIMPLE = 7,
+};
+
+static const unsigned char CBOR_FALSE = 0xf4;
+static const unsigned char CBOR_TRUE = 0xf5;
+static const unsigned char CBOR_NULL = 0xf6;
+static const unsigned char CBOR_UNDEFINED = 0xf7;
+static const unsigned char CBOR_FLOAT16 = 0xf9;
+static const unsigned char CBOR_FLOAT32 = 0xfa;
+static const unsigned char CBOR_FLOAT64 = 0xfb;
+static const unsigned char CBOR_BREAK = 0xff;
+static const unsigned int CBOR_INDEFINITE = 31;
+static const uint64_t CBOR_TAG_JSON = 262;
+
+namespace {
+
+class CBOREncoder : public BinaryWriter {
+public:
+    explicit CBOREncoder(UniValueSink *sink_) : BinaryWriter(sink_) {}
+
+    bool encode(const UniValue& val);
+
+private:
+    void head(unsigned int major, uint64_t n);
+    void number(const std::string& s);
+    void string(const std::string& s);
+};
+
+// initial byte plus argument, in the shortest form
+void CBOREncoder::head(unsigned int major, uint64_t n)
+{
+    unsigned char ib = major << 5;
+    if (n < 24) {
+        buf += (char)(ib | n);
+    } else if (n <= 0xff) {
+        buf += (char)(ib | 24);
+        putBE(n, 1);
+    } else if (n <= 0xffff) {
+        buf += (char)(ib | 25);
+        putBE(n, 2);
+    } else if (n <= 0xffffffffULL) {
+        buf += (char)(ib | 26);
+        putBE(n, 4);
+    } else {
+        buf += (char)(ib | 27);
+        putBE(n, 8);
+    }
+}
+
+void CBOREncoder::number(const std::string& s)
+{
+    int64_t i;
+    uint64_t u;
+    double d;
+    switch (json_classify_number(s, i, u, d)) {
+    case JNUM_INT:
+        if (i >= 0)
+            head(CBOR_UINT, (uint64_t)i);
+        else
+            head(CBOR_NEGINT, (uint64_t)(-(i + 1)));
+        break;
+    case JNUM_UINT:
+        head(CBOR_UINT, u);
+        break;
+    case JNUM_DOUBLE: {
+        float f = (float)d;
+        uint64_t bits;
+        if ((double)f == d) {
+            uint32_t fbits;
+            memcpy(&fbits, &f, sizeof(fbits));
+            buf += (char)CBOR_FLOAT32;
+            putBE(fbits, 4);
+        } else {
+            memcpy(&bits, &d, sizeof(bits));
+            buf += (char)CBOR_FLOAT64;
+            putBE(bits, 8);
+        }
+        break;
+        }
+    case JNUM_TEXT:
+        head(CBOR_TAG, CBOR_TAG_JSON);
+        head(CBOR_BYTES, s.size());
+        buf += s;
+        break;
+    }
+}
+
+// text string, or byte string if s is not valid UTF-8
+void CBOREncoder::string(const std::string& s)
+{
+    head(json_valid_utf8(s) ? CBOR_TEXT : CBOR_BYTES, s.size());
+    buf += s;
+}
+
+bool CBOREncoder::encode(const UniValue& val)
+{
+    switch (val.getType()) {
+    case UniValue::VNULL:
+        buf += (char)CBOR_NULL;
+        break;
+    case UniValue::VBOOL:
+        buf += (char)(val.isTrue() ? CBOR_TRUE : CBOR_FALSE);
+        break;
+    case UniValue::VNUM:
+        number(val.getValStr());
+        break;
+    case UniValue::VSTR:
+        string(val.getValStr());
+        break;
+    case UniValue::VARR: {
+        const std::vector<UniValue>& values = val.getValues();
+        head(CBOR_ARRAY, values.size());
+        for (size_t i = 0; i < values.size(); i++)
+            encode(values[i]);
+        break;
+        }
+    case UniValue::VOBJ: {
+        const std::vector<std::string>& keys = val.getKeys();
+        const std::vector<UniValue>& values = val.getValues();
+        head(CBOR_MAP, keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            string(keys[i]);
+            encode(values[i]);
+        }
+        break;
+        }
+    }
+
+    maybeFlush();
+    return good();
+}
+
+class CBORDecoder : public BinaryReader {
+public:
+    CBORDecoder(const unsigned char *data, size_t len)
+        : BinaryReader(data, len) {}
+
+    bool decode(UniValue& val, size_t depth);
+
+private:
+    bool head(unsigned int& major, unsigned int& info, uint64_t& n);
+    bool string(unsigned int major, unsigned int info, uint64_t n, std::string& s);
+    bool isBreak() const { return p < end && *p == CBOR_BREAK; }
+};
+
+bool CBORDecoder::head(unsigned int& major, unsigned int& info, uint64_t& n)
+{
+    unsigned char ib;
+    if (!getByte(ib))
+        return false;
+    major = ib >> 5;
+    info = ib & 0x1f;
+
+    if (info < 24) {
+        n = info;
+        return true;
+    }
+    switch (info) {
+    case 24: return getBE(1, n);
+    case 25: return getBE(2, n);
+    case 26: return getBE(4, n);
+    case 27: return getBE(8, n);
+    case CBOR_INDEFINITE:
+        n = 0;
+        return (major >= CBOR_BYTES && major <= CBOR_MAP) || major == CBOR_SIMPLE;
+    default:
+        return false;
+    }
+}
+
+bool CBORDecoder::string(unsigned int major, unsigned int info, uint64_t n, std::string& s)
+{
+    if (info != CBOR_INDEFINITE)
+        return getBytes(n, s);
+
+    // indefinite length: definite-length chunks of the same major type
+    while (!isBreak()) {
+        unsigned int chunkMajor, chunkInfo;
+        uint64_t chunkLen;
+        if (!head(chunkMajor, chunkInfo, chunkLen) ||
+            chunkMajor != major || chunkInfo == CBOR_INDEFINITE ||
+            !string(major, chunkInfo, chunkLen, s))
+            return false;
+    }
+    p++;                                    // skip break
+    return true;
+}
+
+static double decodeHalf(uint16_t h)
+{
+    int exp = (h >> 10) & 0x1f;
+    int mant = h & 0x3ff;
+    double val;
+    if (exp == 0)
+        val = ldexp(mant, -24);
+    else if (exp != 31)
+        val = ldexp(mant + 1024, exp - 25);
+    else
+        val = mant == 0 ? INFINITY : NAN;
+    return (h & 0x8000) ? -val : val;
+}
+
+bool CBORDecoder::decode(UniValue& val, size_t depth)
+{
+    if (depth > MAX_CBOR_DEPTH)
+        return false;
+
+    unsigned int major, info;
+    uint64_t n;
+    if (!head(major, info, n))
+        return false;
+
+    switch (major) {
+    case CBOR_UINT:
+        val = UniValue(UniValue::VNUM, json_format_uint(n));
+        return true;
+
+    case CBOR_NEGINT:
+        // -1 - n, which may not fit in an int64_t
+        if (n <= (uint64_t)INT64_MAX)
+            val = UniValue(UniValue::VNUM, json_format_int(-1 - (int64_t)n));
+        else if (n == UINT64_MAX)
+            val = UniValue(UniValue::VNUM, "-18446744073709551616");
+        else
+            val = UniValue(UniValue::VNUM, "-" + json_format_uint(n + 1));
+        return true;
+
+    case CBOR_BYTES:
+    case CBOR_TEXT: {
+        std::string s;
+        if (!string(major, info, n, s))
+            return false;
+        if (major == CBOR_TEXT && !json_valid_utf8(s))
+            return false;
+        val.setStr(s);
+        return true;
+        }
+
+    case CBOR_ARRAY: {
+        val.setArray();
+        if (info != CBOR_INDEFINITE) {
+            if (n > remaining())            // each item is at least one byte
+                return false;
+            val.reserve(n);
+        }
+        for (uint64_t i = 0; info == CBOR_INDEFINITE ? !isBreak() : i < n; i++) {
+            UniValue item;
+            if (!decode(item, depth + 1))
+                return false;
+            val.push_back(std::move(item));
+        }
+        if (info == CBOR_INDEFINITE)
+            p++;                            // skip break
+        return true;
+        }
+
+    case CBOR_MAP: {
+        val.setObject();
+        if (info != CBOR_INDEFINITE) {
+            if (n > remaining() / 2)
+                return false;
+            val.reserve(n);
+        }
+        for (uint64_t i = 0; info == CBOR_INDEFINITE ? !isBreak() : i < n; i++) {
+            unsigned int keyMajor, keyInfo;
+            uint64_t keyLen;
+            std::string key;
+            if (!head(keyMajor, keyInfo, keyLen) ||
+                (keyMajor != CBOR_TEXT && keyMajor != CBOR_BYTES) ||
+                !string(keyMajor, keyInfo, keyLen, key) ||
+                (keyMajor == CBOR_TEXT && !json_valid_utf8(key)))
+                return false;
+
+            UniValue item;
+            if (!decode(item, depth + 1))
+                return false;
+            val.__pushKV(key, std::move(item));
+        }
+        if (info == CBOR_INDEFINITE)
+            p++;                            // skip break
+        return true;
+        }
+
+    case CBOR_TAG:
+        if (n == CBOR_TAG_JSON) {
+            UniValue text;
+            if (!decode(text, depth + 1) || !text.isStr())
+                return false;
+            // only numbers are carried this way
+            return val.setNumStr(text.getValStr());
+        }
+        return decode(val, depth + 1);
+
+    case CBOR_SIMPLE: {
+        double d;
+        switch (info) {
+        case CBOR_FALSE & 0x1f:
+            val.setBool(false);
+            return true;
+        case CBOR_TRUE & 0x1f:
+            val.setBool(true);
+            return true;
+        case CBOR_NULL & 0x1f:
+        case CBOR_UNDEFINED & 0x1f:
+            val.setNull();
+            return true;
+        case CBOR_FLOAT16 & 0x1f:
+            d = decodeHalf((uint16_t)n);
+            break;
+        case CBOR_FLOAT32 & 0x1f: {
+            uint32_t bits = (uint32_t)n;
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            d = f;
+            break;
+            }
+        case CBOR_FLOAT64 & 0x1f:
+            memcpy(&d, &n, sizeof(d));
+            break;
+        default:
+            return false;
+        }
+        // JSON has no representation for NaN or infinities
+        if (!isfinite(d))
+            return false;
+        return val.setFloat(d);
+        }
+    }
+
+    return false;
+}
+
+} // anon namespace
+
+std::string UniValue::writeCBOR() const
+{
+    CBOREncoder enc(NULL);
+    enc.encode(*this);
+    return enc.buf;
+}
+
+bool UniValue::writeCBOR(UniValueSink& sink) const
+{
+    CBOREncoder enc(&sink);
+    return enc.encode(*this) && enc.flush();
+}
+
+bool UniValue::readCBOR(const unsigned char *data, size_t len)
+{
+    clear();
+
+    CBORDecoder dec(data, len);
+    if (!dec.decode(*this, 1) || !dec.atEnd()) {
+        clear();
+        return false;
+    }
+    return true;
+}
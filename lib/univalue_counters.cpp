@@ -0,0 +1,133 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "univalue_counters.h"
+#include "univalue_instrument.h"
+
+#ifdef UNIVALUE_INSTRUMENT
+
+static void addSlots(UniValueCounters& out, const uint64_t *slots)
+{
+    uint64_t sum[UV_COUNTER_SLOTS];
+    memcpy(sum, &out, sizeof(sum));
+    for (size_t i = 0; i < UV_COUNTER_SLOTS; i++)
+        sum[i] += slots[i];
+    memcpy(&out, sum, sizeof(sum));
+}
+
+// The live threads' blocks, and what exited threads had counted since the
+// last reset()
+struct UniValueCounterRegistry {
+    std::mutex mutex;
+    std::vector<UniValueCounterBlock *> blocks;
+    uint64_t retired[UV_COUNTER_SLOTS] = {};
+};
+
+// Never destroyed, as threads may still exit during static destruction
+static UniValueCounterRegistry& registry()
+{
+    static UniValueCounterRegistry *r = new UniValueCounterRegistry;
+    return *r;
+}
+
+// Block's counts since the last reset(); the caller holds the registry lock
+static void readBlock(const UniValueCounterBlock& block, uint64_t *out)
+{
+    for (size_t i = 0; i < UV_COUNTER_SLOTS; i++)
+        out[i] = block.slots[i].load(std::memory_order_relaxed) - block.baseline[i];
+}
+
+UniValueCounterBlock::UniValueCounterBlock()
+{
+    for (size_t i = 0; i < UV_COUNTER_SLOTS; i++) {
+        slots[i].store(0, std::memory_order_relaxed);
+        baseline[i] = 0;
+    }
+    UniValueCounterRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.blocks.push_back(this);
+}
+
+UniValueCounterBlock::~UniValueCounterBlock()
+{
+    UniValueCounterRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t counts[UV_COUNTER_SLOTS];
+    readBlock(*this, counts);
+    for (size_t i = 0; i < UV_COUNTER_SLOTS; i++)
+        r.retired[i] += counts[i];
+    r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), this));
+}
+
+bool UniValueCounters::enabled()
+{
+    return true;
+}
+
+UniValueCounters UniValueCounters::snapshot()
+{
+    UniValueCounters out = {};
+    UniValueCounterRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t counts[UV_COUNTER_SLOTS];
+    for (size_t b = 0; b < r.blocks.size(); b++) {
+        readBlock(*r.blocks[b], counts);
+        addSlots(out, counts);
+    }
+    addSlots(out, r.retired);
+    return out;
+}
+
+UniValueCounters UniValueCounters::threadSnapshot()
+{
+    UniValueCounters out = {};
+    UniValueCounterBlock& block = uvThreadCounters();
+    UniValueCounterRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t counts[UV_COUNTER_SLOTS];
+    readBlock(block, counts);
+    addSlots(out, counts);
+    return out;
+}
+
+void UniValueCounters::reset()
+{
+    // Counters are only ever written by their own thread, so rather than
+    // zero them, move each block's baseline up to its current counts
+    UniValueCounterRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t b = 0; b < r.blocks.size(); b++) {
+        UniValueCounterBlock& block = *r.blocks[b];
+        for (size_t i = 0; i < UV_COUNTER_SLOTS; i++)
+            block.baseline[i] = block.slots[i].load(std::memory_order_relaxed);
+    }
+    memset(r.retired, 0, sizeof(r.retired));
+}
+
+#else
+
+bool UniValueCounters::enabled()
+{
+    return false;
+}
+
+UniValueCounters UniValueCounters::snapshot()
+{
+    return UniValueCounters();
+}
+
+UniValueCounters UniValueCounters::threadSnapshot()
+{
+    return UniValueCounters();
+}
+
+void UniValueCounters::reset()
+{
+}
+
+#endif // UNIVALUE_INSTRUMENT
@@ -0,0 +1,132 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdlib.h>
+#include <string.h>
+#include "univalue_cpu.h"
+#include "univalue_kernels.h"
+
+// Scalar until the tier is chosen, so that kernels called during static
+// initialization still work
+std::atomic<const UniValueKernels *> uvActiveKernels(&uvKernelsScalar);
+
+static const struct {
+    UniValueCPUTier tier;
+    const char *name;
+} tierNames[] = {
+    { CPU_SCALAR, "scalar" },
+    { CPU_SSE2, "sse2" },
+    { CPU_SSE42, "sse4.2" },
+    { CPU_AVX2, "avx2" },
+    { CPU_AVX512, "avx512" },
+    { CPU_NEON, "neon" },
+};
+
+// tier's table, if this build has one
+static const UniValueKernels *kernelsFor(UniValueCPUTier tier)
+{
+    switch (tier) {
+    case CPU_SCALAR: return &uvKernelsScalar;
+#if defined(__SSE2__)
+    case CPU_SSE2: return &uvKernelsSSE2;
+#endif
+#ifdef UNIVALUE_HAVE_SSE42
+    case CPU_SSE42: return &uvKernelsSSE42;
+#endif
+#ifdef UNIVALUE_HAVE_AVX2
+    case CPU_AVX2: return &uvKernelsAVX2;
+#endif
+#ifdef UNIVALUE_HAVE_AVX512
+    case CPU_AVX512: return &uvKernelsAVX512;
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    case CPU_NEON: return &uvKernelsNEON;
+#endif
+    default: return NULL;
+    }
+}
+
+// Whether this machine has what tier's table was built for.  GCC and
+// Clang also check that the OS saves the AVX and AVX-512 registers.
+static bool machineHas(UniValueCPUTier tier)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    switch (tier) {
+    case CPU_SSE42: return __builtin_cpu_supports("sse4.2");
+    case CPU_AVX2: return __builtin_cpu_supports("avx2");
+    case CPU_AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    default: break;
+    }
+#endif
+    // the others are the baseline of the architecture they were built for
+    return true;
+}
+
+bool uvCPUSupports(UniValueCPUTier tier)
+{
+    return kernelsFor(tier) && machineHas(tier);
+}
+
+// The best supported tier up to max
+static UniValueCPUTier bestUpTo(UniValueCPUTier max)
+{
+    for (int t = max; t > CPU_SCALAR; t--) {
+        if (uvCPUSupports((UniValueCPUTier)t))
+            return (UniValueCPUTier)t;
+    }
+    return CPU_SCALAR;
+}
+
+UniValueCPUTier uvCPUBestTier()
+{
+    return bestUpTo(CPU_NEON);
+}
+
+UniValueCPUTier uvCPUTier()
+{
+    return uvKernels().tier;
+}
+
+bool uvSetCPUTier(UniValueCPUTier tier)
+{
+    if (!uvCPUSupports(tier))
+        return false;
+    uvActiveKernels.store(kernelsFor(tier), std::memory_order_relaxed);
+    return true;
+}
+
+const char *uvCPUTierName(UniValueCPUTier tier)
+{
+    for (size_t i = 0; i < sizeof(tierNames) / sizeof(tierNames[0]); i++) {
+        if (tierNames[i].tier == tier)
+            return tierNames[i].name;
+    }
+    return NULL;
+}
+
+bool uvCPUTierFromName(const char *name, UniValueCPUTier& tier)
+{
+    for (size_t i = 0; i < sizeof(tierNames) / sizeof(tierNames[0]); i++) {
+        if (strcmp(tierNames[i].name, name) == 0) {
+            tier = tierNames[i].tier;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Choose once, when the library is loaded
+static struct UniValueCPUChoice {
+    UniValueCPUChoice()
+    {
+        UniValueCPUTier tier = uvCPUBestTier();
+        const char *env = getenv("UNIVALUE_CPU");
+        UniValueCPUTier wanted;
+        if (env && uvCPUTierFromName(env, wanted) && wanted < tier)
+            tier = bestUpTo(wanted);
+        uvSetCPUTier(tier);
+    }
+} cpuChoice;
@@ -0,0 +1,54 @@
+// Copyright 2014 BitPay Inc.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+#ifndef UNIVALUE_FORMAT_H
+#define UNIVALUE_FORMAT_H
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * Text formatting shared by UniValue::write() and the streaming writers,
+ * so that both produce byte-identical JSON.
+ *
+ * These are internal to the library: they are kept out of the shared
+ * library's exported symbols, and are not part of its ABI.
+ */
+#if defined(__GNUC__) && !defined(_WIN32)
+#define UNIVALUE_INTERNAL __attribute__((visibility("hidden")))
+#else
+#define UNIVALUE_INTERNAL
+#endif
+
+// Append inS to outS with JSON string escaping applied (no quotes)
+UNIVALUE_INTERNAL void json_escape(const std::string& inS, std::string& outS);
+UNIVALUE_INTERNAL void json_escape(const char *in, size_t len, std::string& outS);
+
+// Canonical number text, as stored by UniValue::setInt() / setFloat()
+UNIVALUE_INTERNAL std::string json_format_int(int64_t n);
+UNIVALUE_INTERNAL std::string json_format_uint(uint64_t n);
+UNIVALUE_INTERNAL std::string json_format_float(double n);
+
+// Strict number parsing for the get_int()/get_int64()/get_real() family.
+// str must be NUL-terminated at str[len].
+UNIVALUE_INTERNAL bool json_parse_int32(const char *str, size_t len, int32_t *out);
+UNIVALUE_INTERNAL bool json_parse_int64(const char *str, size_t len, int64_t *out);
+UNIVALUE_INTERNAL bool json_parse_double(const char *str, size_t len, double *out);
+
+// Hex conversion, for binary data carried as hex strings.  Decoding reads
+// 2 * n digits of either case into n bytes, and fails if any is not a hex
+// digit; encoding writes 2 * n lowercase digits.
+UNIVALUE_INTERNAL bool json_hex_decode(const char *in, size_t n, uint8_t *out);
+UNIVALUE_INTERNAL void json_hex_encode(const uint8_t *in, size_t n, char *out);
+
+// How a JSON number's text can be represented in a binary encoding
+// without changing that text when it is decoded again
+enum json_num_kind {
+    JNUM_INT,       // fits int64_t, stored in i
+    JNUM_UINT,      // fits uint64_t but not int64_t, stored in u
+    JNUM_DOUBLE,    // json_format_float(d) reproduces the text exactly
+    JNUM_TEXT,      // must be carried as text
+};
+UNIVALUE_INTERNAL json_num_kind json_classify_number(const std::string& s, int64_t& i, uint64_t& u, double& d);
+
+#endif
@@ -14,27 +14,26 @@
 #include <sstream>
 
 #include "univalue.h"
+#include "univalue_format.h"
 
-namespace
+static bool ParsePrechecks(const char *str, size_t len)
 {
-static bool ParsePrechecks(const std::string& str)
-{
-    if (str.empty()) // No empty string allowed
+    if (len == 0) // No empty string allowed
         return false;
-    if (str.size() >= 1 && (json_isspace(str[0]) || json_isspace(str[str.size()-1]))) // No padding allowed
+    if (len >= 1 && (json_isspace(str[0]) || json_isspace(str[len-1]))) // No padding allowed
         return false;
-    if (str.size() != strlen(str.c_str())) // No embedded NUL characters allowed
+    if (len != strlen(str)) // No embedded NUL characters allowed
         return false;
     return true;
 }
 
-bool ParseInt32(const std::string& str, int32_t *out)
+bool json_parse_int32(const char *str, size_t len, int32_t *out)
 {
-    if (!ParsePrechecks(str))
+    if (!ParsePrechecks(str, len))
         return false;
     char *endp = NULL;
     errno = 0; // strtol will not set errno if valid
-    long int n = strtol(str.c_str(), &endp, 10);
+    long int n = strtol(str, &endp, 10);
     if(out) *out = (int32_t)n;
     // Note that strtol returns a *long int*, so even if strtol doesn't report a over/underflow
     // we still have to check that the returned value is within the range of an *int32_t*. On 64-bit
@@ -44,13 +43,13 @@ bool ParseInt32(const std::string& str, int32_t *out)
         n <= std::numeric_limits<int32_t>::max();
 }
 
-bool ParseInt64(const std::string& str, int64_t *out)
+bool json_parse_int64(const char *str, size_t len, int64_t *out)
 {
-    if (!ParsePrechecks(str))
+    if (!ParsePrechecks(str, len))
         return false;
     char *endp = NULL;
     errno = 0; // strtoll will not set errno if valid
-    long long int n = strtoll(str.c_str(), &endp, 10);
+    long long int n = strtoll(str, &endp, 10);
     if(out) *out = (int64_t)n;
     // Note that strtoll returns a *long long int*, so even if strtol doesn't report a over/underflow
     // we still have to check that the returned value is within the range of an *int64_t*.
@@ -59,20 +58,19 @@ bool ParseInt64(const std::string& str, int64_t *out)
         n <= std::numeric_limits<int64_t>::max();
 }
 
-bool ParseDouble(const std::string& str, double *out)
+bool json_parse_double(const char *str, size_t len, double *out)
 {
-    if (!ParsePrechecks(str))
+    if (!ParsePrechecks(str, len))
         return false;
-    if (str.size() >= 2 && str[0] == '0' && str[1] == 'x') // No hexadecimal floats allowed
+    if (len >= 2 && str[0] == '0' && str[1] == 'x') // No hexadecimal floats allowed
         return false;
-    std::istringstream text(str);
+    std::istringstream text(std::string(str, len));
     text.imbue(std::locale::classic());
     double result;
     text >> result;
     if(out) *out = result;
     return text.eof() && !text.fail();
 }
-}
 
 const std::vector<std::string>& UniValue::getKeys() const
 {
@@ -102,12 +100,26 @@ const std::string& UniValue::get_str() const
     return getValStr();
 }
 
+std::string_view UniValue::get_str_view() const
+{
+    if (typ != VSTR)
+        throw std::runtime_error("JSON value is not a string as expected");
+    return val;
+}
+
+std::string_view UniValue::key(size_t index) const
+{
+    if (typ != VOBJ)
+        throw std::runtime_error("JSON value is not an object as expected");
+    return keys.at(index);
+}
+
 int UniValue::get_int() const
 {
     if (typ != VNUM)
         throw std::runtime_error("JSON value is not an integer as expected");
     int32_t retval;
-    if (!ParseInt32(getValStr(), &retval))
+    if (!json_parse_int32(val.c_str(), val.size(), &retval))
         throw std::runtime_error("JSON integer out of range");
     return retval;
 }
@@ -117,7 +129,7 @@ int64_t UniValue::get_int64() const
     if (typ != VNUM)
         throw std::runtime_error("JSON value is not an integer as expected");
     int64_t retval;
-    if (!ParseInt64(getValStr(), &retval))
+    if (!json_parse_int64(val.c_str(), val.size(), &retval))
         throw std::runtime_error("JSON integer out of range");
     return retval;
 }
@@ -127,7 +139,7 @@ double UniValue::get_real() const
     if (typ != VNUM)
         throw std::runtime_error("JSON value is not a number as expected");
     double retval;
-    if (!ParseDouble(getValStr(), &retval))
+    if (!json_parse_double(val.c_str(), val.size(), &retval))
         throw std::runtime_error("JSON double out of range");
     return retval;
 }
@@ -146,3 +158,25 @@ const UniValue& UniValue::get_array() const
     return *this;
 }
 
+void UniValue::get_hex(std::vector<uint8_t>& out) const
+{
+    if (typ != VSTR)
+        throw std::runtime_error("JSON value is not a string as expected");
+    if (val.size() % 2)
+        throw std::runtime_error("JSON value is not a hex string as expected");
+    std::vector<uint8_t> bytes(val.size() / 2);
+    if (!json_hex_decode(val.data(), bytes.size(), bytes.data()))
+        throw std::runtime_error("JSON value is not a hex string as expected");
+    out.swap(bytes);
+}
+
+void UniValue::get_hex(uint8_t *out, size_t size) const
+{
+    if (typ != VSTR)
+        throw std::runtime_error("JSON value is not a string as expected");
+    if (val.size() != 2 * size)
+        throw std::runtime_error("JSON value is not a hex string of the expected length");
+    if (!json_hex_decode(val.data(), size, out))
+        throw std::runtime_error("JSON value is not a hex string as expected");
+}
+
@@ -0,0 +1,56 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef UNIVALUE_INSTRUMENT_H
+#define UNIVALUE_INSTRUMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "univalue_counters.h"
+
+// Every member of UniValueCounters is a uint64_t, so each one, and each
+// element of the arrays, is a slot numbered by its offset
+static const size_t UV_COUNTER_SLOTS = sizeof(UniValueCounters) / sizeof(uint64_t);
+#define UV_SLOT(field) (offsetof(UniValueCounters, field) / sizeof(uint64_t))
+
+#ifdef UNIVALUE_INSTRUMENT
+
+#include <atomic>
+
+// One thread's counters, registered for snapshots while the thread lives
+struct UniValueCounterBlock {
+    std::atomic<uint64_t> slots[UV_COUNTER_SLOTS];
+    uint64_t baseline[UV_COUNTER_SLOTS];        // at the last reset()
+
+    UniValueCounterBlock();
+    ~UniValueCounterBlock();
+};
+
+// Not static, so that all of the library shares each thread's block
+inline UniValueCounterBlock& uvThreadCounters()
+{
+    static thread_local UniValueCounterBlock block;
+    return block;
+}
+
+// Only the owning thread writes its block, so a relaxed load and store
+// will do, and costs much less than a locked add
+static inline void uvCount(size_t slot, uint64_t n)
+{
+    std::atomic<uint64_t>& c = uvThreadCounters().slots[slot];
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+#define UV_COUNT(field, n) uvCount(UV_SLOT(field), (n))
+#define UV_COUNT_AT(field, i, n) uvCount(UV_SLOT(field) + (size_t)(i), (n))
+
+#else
+
+#define UV_COUNT(field, n) ((void)0)
+#define UV_COUNT_AT(field, i, n) ((void)0)
+
+#endif // UNIVALUE_INSTRUMENT
+
+#endif // UNIVALUE_INSTRUMENT_H
@@ -0,0 +1,514 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "univalue.h"
+#include "univalue_jsonpath.h"
+#include "univalue_sax.h"
+#include "univalue_format.h"
+
+static bool isNameChar(char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+           (ch >= '0' && ch <= '9') || ch == '_' || ch == '-' || ch == '$' ||
+           (unsigned char)ch >= 0x80;
+}
+
+static void skipSpace(const std::string& s, size_t& pos)
+{
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t'))
+        pos++;
+}
+
+static bool parseName(const std::string& s, size_t& pos, std::string& name)
+{
+    size_t start = pos;
+    while (pos < s.size() && isNameChar(s[pos]))
+        pos++;
+    name = s.substr(start, pos - start);
+    return !name.empty();
+}
+
+// 'text' or "text"; a backslash escapes the next character
+static bool parseQuoted(const std::string& s, size_t& pos, std::string& str)
+{
+    if (pos >= s.size() || (s[pos] != '\'' && s[pos] != '"'))
+        return false;
+    char quote = s[pos++];
+    str.clear();
+    while (pos < s.size() && s[pos] != quote) {
+        if (s[pos] == '\\' && ++pos >= s.size())
+            return false;
+        str += s[pos++];
+    }
+    if (pos >= s.size())
+        return false;
+    pos++;
+    return true;
+}
+
+static bool parseIndex(const std::string& s, size_t& pos, size_t& index)
+{
+    size_t start = pos;
+    index = 0;
+    while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') {
+        unsigned int digit = s[pos] - '0';
+        if (index > (SIZE_MAX - digit) / 10)
+            return false;
+        index = index * 10 + digit;
+        pos++;
+    }
+    // no leading zeros
+    return pos > start && (s[start] != '0' || pos == start + 1);
+}
+
+static void appendPointer(std::string& pointer, const std::string& seg)
+{
+    pointer += '/';
+    for (size_t i = 0; i < seg.size(); i++) {
+        if (seg[i] == '~')
+            pointer += "~0";
+        else if (seg[i] == '/')
+            pointer += "~1";
+        else
+            pointer += seg[i];
+    }
+}
+
+UniValueJSONPath::UniValueJSONPath(const std::string& path)
+{
+    if (!parse(path))
+        throw std::runtime_error("Invalid JSONPath: " + path);
+}
+
+bool UniValueJSONPath::parse(const std::string& path)
+{
+    text.clear();
+    steps.clear();
+
+    const std::string& s = path;
+    size_t pos = 0;
+    if (s.empty() || s[pos++] != '$')
+        return false;
+
+    std::vector<Step> parsed;
+    while (pos < s.size()) {
+        Step step;
+        step.kind = STEP_KEY;
+        step.recursive = false;
+        step.index = 0;
+        step.op = OP_EXISTS;
+
+        if (s.compare(pos, 2, "..") == 0) {
+            step.recursive = true;
+            pos += 2;
+        } else if (s[pos] == '.') {
+            pos++;
+        } else if (s[pos] != '[') {
+            return false;
+        }
+
+        if (pos < s.size() && s[pos] == '*' && (step.recursive || s[pos - 1] == '.')) {
+            step.kind = STEP_WILDCARD;
+            pos++;
+        } else if (pos < s.size() && s[pos] == '[') {
+            pos++;
+            if (pos < s.size() && s[pos] == '*') {
+                step.kind = STEP_WILDCARD;
+                pos++;
+            } else if (s.compare(pos, 2, "?(") == 0) {
+                // ?(@relpath [op literal])
+                step.kind = STEP_FILTER;
+                pos += 2;
+                skipSpace(s, pos);
+                if (pos >= s.size() || s[pos++] != '@')
+                    return false;
+
+                std::string pointer, seg;
+                while (pos < s.size() && (s[pos] == '.' || s[pos] == '[')) {
+                    if (s[pos++] == '.') {
+                        if (!parseName(s, pos, seg))
+                            return false;
+                    } else {
+                        size_t index;
+                        size_t start = pos;
+                        if (parseIndex(s, pos, index))
+                            seg = s.substr(start, pos - start);
+                        else if (!parseQuoted(s, pos, seg))
+                            return false;
+                        if (pos >= s.size() || s[pos++] != ']')
+                            return false;
+                    }
+                    appendPointer(pointer, seg);
+                }
+                if (!step.target.parse(pointer))
+                    return false;
+
+                skipSpace(s, pos);
+                static const std::pair<const char *, FilterOp> ops[] = {
+                    { "==", OP_EQ }, { "!=", OP_NE }, { "<=", OP_LE },
+                    { ">=", OP_GE }, { "<", OP_LT }, { ">", OP_GT },
+                };
+                for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+                    std::string op(ops[i].first);
+                    if (s.compare(pos, op.size(), op) == 0) {
+                        step.op = ops[i].second;
+                        pos += op.size();
+                        break;
+                    }
+                }
+
+                if (step.op != OP_EXISTS) {
+                    skipSpace(s, pos);
+                    std::string lit;
+                    if (pos < s.size() && (s[pos] == '\'' || s[pos] == '"')) {
+                        if (!parseQuoted(s, pos, lit))
+                            return false;
+                        step.literal.setStr(lit);
+                    } else {
+                        size_t start = pos;
+                        while (pos < s.size() && (isNameChar(s[pos]) || s[pos] == '.' || s[pos] == '+'))
+                            pos++;
+                        lit = s.substr(start, pos - start);
+
+                        // setNumStr() alone would accept trailing junk
+                        std::string num;
+                        unsigned int consumed;
+                        if (lit == "true" || lit == "false")
+                            step.literal.setBool(lit == "true");
+                        else if (lit == "null")
+                            step.literal.setNull();
+                        else if (getJsonToken(num, consumed, lit.data(), lit.data() + lit.size()) != JTOK_NUMBER ||
+                                 consumed != lit.size() || !step.literal.setNumStr(num))
+                            return false;
+                    }
+                    skipSpace(s, pos);
+                }
+                if (pos >= s.size() || s[pos++] != ')')
+                    return false;
+            } else if (pos < s.size() && (s[pos] == '\'' || s[pos] == '"')) {
+                if (!parseQuoted(s, pos, step.key))
+                    return false;
+            } else {
+                step.kind = STEP_INDEX;
+                if (!parseIndex(s, pos, step.index))
+                    return false;
+            }
+            if (pos >= s.size() || s[pos++] != ']')
+                return false;
+        } else if (!parseName(s, pos, step.key)) {
+            return false;
+        }
+
+        parsed.push_back(step);
+        if (parsed.size() > MAX_STEPS)
+            return false;
+    }
+
+    text = path;
+    steps.swap(parsed);
+    return true;
+}
+
+bool UniValueJSONPath::hasFilter(uint64_t states) const
+{
+    for (size_t i = 0; i < steps.size(); i++) {
+        if ((states & (1ULL << i)) && steps[i].kind == STEP_FILTER)
+            return true;
+    }
+    return false;
+}
+
+// The states of a child, given its parent's states.  Filters only match
+// if the child itself is supplied.
+uint64_t UniValueJSONPath::advance(uint64_t states, bool isIndex, std::string_view key,
+                                   size_t index, const UniValue *child) const
+{
+    uint64_t next = 0;
+    for (size_t i = 0; i < steps.size(); i++) {
+        if (!(states & (1ULL << i)))
+            continue;
+
+        const Step& s = steps[i];
+        if (s.recursive)
+            next |= (1ULL << i);
+
+        bool hit = false;
+        switch (s.kind) {
+        case STEP_KEY:      hit = !isIndex && key == s.key; break;
+        case STEP_INDEX:    hit = isIndex && index == s.index; break;
+        case STEP_WILDCARD: hit = true; break;
+        case STEP_FILTER:   hit = child && test(s, *child); break;
+        }
+        if (hit)
+            next |= (1ULL << (i + 1));
+    }
+    return next;
+}
+
+bool UniValueJSONPath::test(const Step& s, const UniValue& child)
+{
+    const UniValue& val = child.resolve(s.target);
+    if (&val == &NullUniValue)
+        return s.op == OP_NE;
+    if (s.op == OP_EXISTS)
+        return true;
+
+    const UniValue& lit = s.literal;
+    bool eq = false, lt = false, ordered = false;
+    if (val.getType() == lit.getType()) {
+        switch (val.getType()) {
+        case UniValue::VNULL:
+            eq = true;
+            break;
+        case UniValue::VBOOL:
+            eq = (val.isTrue() == lit.isTrue());
+            break;
+        case UniValue::VSTR:
+            eq = (val.getValStr() == lit.getValStr());
+            lt = (val.getValStr() < lit.getValStr());
+            ordered = true;
+            break;
+        case UniValue::VNUM: {
+            double a, b;
+            const std::string& sa = val.getValStr();
+            const std::string& sb = lit.getValStr();
+            if (json_parse_double(sa.c_str(), sa.size(), &a) &&
+                json_parse_double(sb.c_str(), sb.size(), &b)) {
+                eq = (a == b);
+                lt = (a < b);
+                ordered = true;
+            }
+            break;
+            }
+        case UniValue::VARR:
+        case UniValue::VOBJ:
+            break;
+        }
+    }
+
+    switch (s.op) {
+    case OP_EQ: return eq;
+    case OP_NE: return !eq;
+    case OP_LT: return lt;
+    case OP_LE: return lt || eq;
+    case OP_GT: return ordered && !lt && !eq;
+    case OP_GE: return (ordered && !lt) || eq;
+    case OP_EXISTS: break;
+    }
+    return false;
+}
+
+void UniValueJSONPath::select(const UniValue& node, uint64_t states,
+                              std::vector<const UniValue*>& out) const
+{
+    if (states & matched())
+        out.push_back(&node);
+
+    if (node.isArray()) {
+        const std::vector<UniValue>& values = node.getValues();
+        for (size_t i = 0; i < values.size(); i++) {
+            uint64_t next = advance(states, true, std::string_view(), i, &values[i]);
+            if (next)
+                select(values[i], next, out);
+        }
+    } else if (node.isObject()) {
+        const std::vector<std::string>& keys = node.getKeys();
+        const std::vector<UniValue>& values = node.getValues();
+        for (size_t i = 0; i < values.size(); i++) {
+            uint64_t next = advance(states, false, keys[i], 0, &values[i]);
+            if (next)
+                select(values[i], next, out);
+        }
+    }
+}
+
+void UniValueJSONPath::select(const UniValue& root, std::vector<const UniValue*>& out) const
+{
+    out.clear();
+    if (!text.empty())
+        select(root, 1, out);
+}
+
+/**
+ * Streaming evaluation.  Each open container that can still lead to a
+ * match has a frame holding its states; anything else is skipped by the
+ * parser.  A child that matches outright, or that a filter has to look
+ * at, is built into a UniValue and finished off with the tree evaluator,
+ * so both modes return the same results in the same order.
+ */
+class UniValueJSONPathHandler : public UniValueSAXHandler {
+public:
+    UniValueJSONPathHandler(const UniValueJSONPath& path_, std::vector<UniValue>& out_)
+        : path(path_), out(out_), building(false) {}
+
+    Action onNull() override { return value(UniValue()); }
+    Action onBool(bool val) override { return value(UniValue(val)); }
+    Action onNumber(const std::string& text) override { return value(UniValue(UniValue::VNUM, text)); }
+    Action onString(const std::string& str) override { return value(UniValue(UniValue::VSTR, str)); }
+    Action onBeginObject() override { return begin(UniValue::VOBJ); }
+    Action onBeginArray() override { return begin(UniValue::VARR); }
+
+    Action onKey(const std::string& key) override {
+        if (building) {
+            pendingKey = key;
+            return SAX_OK;
+        }
+        Frame& top = stack.back();
+        top.key = key;
+        top.childStates = path.advance(top.states, false, key, 0, NULL);
+        if (!top.childStates && !path.hasFilter(top.states))
+            return SAX_SKIP;
+        return SAX_OK;
+    }
+
+    Action onEndObject() override { return end(); }
+    Action onEndArray() override { return end(); }
+
+private:
+    struct Frame {
+        uint64_t states;
+        bool isArray;
+        size_t count;                   // array: elements so far
+        std::string key;                // object: current member
+        uint64_t childStates;           // object: states of current member
+    };
+
+    const UniValueJSONPath& path;
+    std::vector<UniValue>& out;
+    std::vector<Frame> stack;
+
+    // The subtree being built, as a stack of open containers and the keys
+    // they will be added under; parentStates etc. locate it in the document
+    bool building;
+    std::vector<UniValue> buildStack;
+    std::vector<std::string> buildKeys;
+    std::string pendingKey;
+    bool isRoot;
+    uint64_t parentStates;
+    bool isIndex;
+    std::string key;
+    size_t index;
+
+    // Decide what to do with a value that is starting: 1 to build it,
+    // 0 to skip it, -1 to descend into it with states
+    int enter(uint64_t& states) {
+        isRoot = stack.empty();
+        if (isRoot) {
+            states = 1;
+            return (states & path.matched()) ? 1 : -1;
+        }
+
+        Frame& top = stack.back();
+        parentStates = top.states;
+        isIndex = top.isArray;
+        if (top.isArray) {
+            index = top.count++;
+            states = path.advance(top.states, true, std::string_view(), index, NULL);
+        } else {
+            key = top.key;
+            states = top.childStates;
+        }
+        if ((states & path.matched()) || path.hasFilter(top.states))
+            return 1;
+        return states ? -1 : 0;
+    }
+
+    Action begin(UniValue::VType type) {
+        if (building) {
+            buildStack.push_back(UniValue(type));
+            buildKeys.push_back(pendingKey);
+            return SAX_OK;
+        }
+
+        uint64_t states;
+        int action = enter(states);
+        if (action == 0)
+            return SAX_SKIP;
+        if (action > 0) {
+            building = true;
+            buildStack.assign(1, UniValue(type));
+            buildKeys.assign(1, std::string());
+            return SAX_OK;
+        }
+
+        Frame f;
+        f.states = states;
+        f.isArray = (type == UniValue::VARR);
+        f.count = 0;
+        f.childStates = 0;
+        stack.push_back(f);
+        return SAX_OK;
+    }
+
+    Action value(UniValue val) {
+        if (building) {
+            add(std::move(val), pendingKey);
+            return SAX_OK;
+        }
+
+        uint64_t states;
+        if (enter(states) > 0)
+            finish(val);
+        return SAX_OK;
+    }
+
+    Action end() {
+        if (!building) {
+            stack.pop_back();
+            return SAX_OK;
+        }
+
+        UniValue val(std::move(buildStack.back()));
+        std::string k(std::move(buildKeys.back()));
+        buildStack.pop_back();
+        buildKeys.pop_back();
+        add(std::move(val), k);
+        return SAX_OK;
+    }
+
+    void add(UniValue val, const std::string& k) {
+        if (buildStack.empty()) {
+            building = false;
+            finish(val);
+        } else if (buildStack.back().isObject()) {
+            buildStack.back().__pushKV(k, std::move(val));
+        } else {
+            buildStack.back().push_back(std::move(val));
+        }
+    }
+
+    // A complete candidate: find its matches with the tree evaluator
+    void finish(UniValue& val) {
+        uint64_t states = isRoot ? 1 : path.advance(parentStates, isIndex, key, index, &val);
+        std::vector<const UniValue*> matches;
+        if (states)
+            path.select(val, states, matches);
+
+        if (matches.size() == 1 && matches[0] == &val) {
+            out.push_back(std::move(val));
+            return;
+        }
+        for (size_t i = 0; i < matches.size(); i++)
+            out.push_back(*matches[i]);
+    }
+};
+
+bool UniValueJSONPath::selectJSON(const char *raw, size_t size, std::vector<UniValue>& out) const
+{
+    out.clear();
+    if (text.empty())
+        return false;
+
+    UniValueJSONPathHandler handler(*this, out);
+    if (!readJsonSAX(raw, size, handler)) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
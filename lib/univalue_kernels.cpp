@@ -0,0 +1,419 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+// The scalar kernels, and those for the baseline vector instruction set
+// of the architecture, which need no special compiler flags
+
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "univalue_format.h"
+#include "univalue_kernels.h"
+
+// Value of each hex digit, or -1
+static const signed char hexDigitTable[256] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+     0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+};
+
+static const char hexDigits[] = "0123456789abcdef";
+
+//
+// Scalar
+//
+
+size_t uvStringRunScalar(const char *p, size_t n)
+{
+    size_t i = 0;
+    while (i < n && !uvIsStringStop(p[i]))
+        i++;
+    return i;
+}
+
+size_t uvStructuralRunScalar(const char *p, size_t n)
+{
+    size_t i = 0;
+    while (i < n && !uvIsStructural(p[i]))
+        i++;
+    return i;
+}
+
+size_t uvAsciiRunScalar(const char *p, size_t n)
+{
+    size_t i = 0;
+    while (i < n && (unsigned char)p[i] < 0x80)
+        i++;
+    return i;
+}
+
+size_t uvEscapeRunScalar(const char *p, size_t n)
+{
+    size_t i = 0;
+    while (i < n && !uvIsEscaped(p[i]))
+        i++;
+    return i;
+}
+
+size_t uvByteRunScalar(const char *p, size_t n, unsigned char b)
+{
+    size_t i = 0;
+    while (i < n && (unsigned char)p[i] != b)
+        i++;
+    return i;
+}
+
+bool uvHexDecodeScalar(const char *in, size_t n, uint8_t *out)
+{
+    for (size_t i = 0; i < n; i++) {
+        int high = hexDigitTable[(unsigned char)in[2 * i]];
+        int low = hexDigitTable[(unsigned char)in[2 * i + 1]];
+        if ((high | low) < 0)
+            return false;
+        out[i] = (uint8_t)(high << 4 | low);
+    }
+    return true;
+}
+
+void uvHexEncodeScalar(const uint8_t *in, size_t n, char *out)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[2 * i] = hexDigits[in[i] >> 4];
+        out[2 * i + 1] = hexDigits[in[i] & 0x0f];
+    }
+}
+
+const UniValueKernels uvKernelsScalar = {
+    CPU_SCALAR,
+    uvStringRunScalar,
+    uvStructuralRunScalar,
+    uvAsciiRunScalar,
+    uvEscapeRunScalar,
+    uvByteRunScalar,
+    uvHexDecodeScalar,
+    uvHexEncodeScalar,
+};
+
+//
+// SSE2
+//
+
+#if defined(__SSE2__)
+// Scan 16 bytes at a time for the lanes stops() sets, leaving the rest
+// to the scalar kernel
+template <__m128i (*stops)(__m128i), size_t (*tail)(const char *, size_t)>
+static inline size_t runSSE2(const char *p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned int mask = _mm_movemask_epi8(stops(c));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + tail(p + i, n - i);
+}
+
+static inline __m128i eq(__m128i c, char ch)
+{
+    return _mm_cmpeq_epi8(c, _mm_set1_epi8(ch));
+}
+
+static inline __m128i stringStops(__m128i c)
+{
+    // a signed compare takes in both control characters and non-ASCII
+    __m128i special = _mm_cmplt_epi8(c, _mm_set1_epi8(0x20));
+    return _mm_or_si128(special, _mm_or_si128(eq(c, '"'), eq(c, '\\')));
+}
+
+static inline __m128i structuralStops(__m128i c)
+{
+    // '[' and ']' differ from '{' and '}' only in bit 5
+    __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i brackets = _mm_or_si128(eq(folded, '{'), eq(folded, '}'));
+    return _mm_or_si128(_mm_or_si128(brackets, eq(c, ',')),
+                        _mm_or_si128(eq(c, '"'), eq(c, '\\')));
+}
+
+static inline __m128i asciiStops(__m128i c)
+{
+    return c;                           // only the top bits count
+}
+
+static inline __m128i escapeStops(__m128i c)
+{
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(c, _mm_set1_epi8(0x1f)), c);
+    return _mm_or_si128(_mm_or_si128(control, eq(c, 0x7f)),
+                        _mm_or_si128(eq(c, '"'), eq(c, '\\')));
+}
+
+size_t uvStringRunSSE2(const char *p, size_t n)
+{
+    return runSSE2<stringStops, uvStringRunScalar>(p, n);
+}
+
+size_t uvStructuralRunSSE2(const char *p, size_t n)
+{
+    return runSSE2<structuralStops, uvStructuralRunScalar>(p, n);
+}
+
+size_t uvAsciiRunSSE2(const char *p, size_t n)
+{
+    return runSSE2<asciiStops, uvAsciiRunScalar>(p, n);
+}
+
+size_t uvEscapeRunSSE2(const char *p, size_t n)
+{
+    return runSSE2<escapeStops, uvEscapeRunScalar>(p, n);
+}
+
+size_t uvByteRunSSE2(const char *p, size_t n, unsigned char b)
+{
+    const __m128i needle = _mm_set1_epi8((char)b);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(c, needle));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + uvByteRunScalar(p + i, n - i, b);
+}
+
+// Lanes of c whose unsigned value is in [lo, lo + n)
+static inline __m128i inRange(__m128i c, char lo, unsigned char n)
+{
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    __m128i t = _mm_xor_si128(_mm_sub_epi8(c, _mm_set1_epi8(lo)), bias);
+    return _mm_cmplt_epi8(t, _mm_set1_epi8((char)(n ^ 0x80)));
+}
+
+// Decode 16 digits to 8 bytes, in the low half of the result; ok is
+// cleared if any digit is invalid
+static inline __m128i decode16(const char *in, int& ok)
+{
+    __m128i c = _mm_loadu_si128((const __m128i *)in);
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i isDigit = inRange(c, '0', 10);
+    __m128i isAlpha = inRange(lower, 'a', 6);
+    ok &= (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) == 0xffff);
+
+    // '0'-'9' end in 0-9, and 'a'-'f' and 'A'-'F' in 1-6
+    __m128i nibble = _mm_add_epi8(_mm_and_si128(c, _mm_set1_epi8(0x0f)),
+                                  _mm_and_si128(isAlpha, _mm_set1_epi8(9)));
+    // each 16-bit lane holds (high digit, low digit); combine them
+    __m128i high = _mm_slli_epi16(_mm_and_si128(nibble, _mm_set1_epi16(0x00ff)), 4);
+    __m128i low = _mm_srli_epi16(nibble, 8);
+    return _mm_or_si128(high, low);
+}
+bool uvHexDecodeSSE2(const char *in, size_t n, uint8_t *out)
+{
+    size_t i = 0;
+    int ok = 1;
+    for (; i + 16 <= n; i += 16) {
+        __m128i first = decode16(in + 2 * i, ok);
+        __m128i second = decode16(in + 2 * i + 16, ok);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(first, second));
+    }
+    return ok && uvHexDecodeScalar(in + 2 * i, n - i, out + i);
+}
+
+void uvHexEncodeSSE2(const uint8_t *in, size_t n, char *out)
+{
+    size_t i = 0;
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+        __m128i low = _mm_and_si128(b, mask);
+        // n < 10 ? '0' + n : 'a' + n - 10
+        __m128i h = _mm_add_epi8(_mm_add_epi8(high, _mm_set1_epi8('0')),
+                                 _mm_and_si128(_mm_cmpgt_epi8(high, _mm_set1_epi8(9)),
+                                               _mm_set1_epi8('a' - '0' - 10)));
+        __m128i l = _mm_add_epi8(_mm_add_epi8(low, _mm_set1_epi8('0')),
+                                 _mm_and_si128(_mm_cmpgt_epi8(low, _mm_set1_epi8(9)),
+                                               _mm_set1_epi8('a' - '0' - 10)));
+        _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(h, l));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(h, l));
+    }
+    uvHexEncodeScalar(in + i, n - i, out + 2 * i);
+}
+
+const UniValueKernels uvKernelsSSE2 = {
+    CPU_SSE2,
+    uvStringRunSSE2,
+    uvStructuralRunSSE2,
+    uvAsciiRunSSE2,
+    uvEscapeRunSSE2,
+    uvByteRunSSE2,
+    uvHexDecodeSSE2,
+    uvHexEncodeSSE2,
+};
+#endif // __SSE2__
+
+//
+// NEON
+//
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+// NEON has no movemask; narrowing a comparison result leaves four bits
+// per lane instead
+static inline uint64_t laneBits(uint8x16_t m)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+template <uint8x16_t (*stops)(uint8x16_t), size_t (*tail)(const char *, size_t)>
+static inline size_t runNEON(const char *p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint64_t bits = laneBits(stops(vld1q_u8((const uint8_t *)p + i)));
+        if (bits)
+            return i + (__builtin_ctzll(bits) >> 2);
+    }
+    return i + tail(p + i, n - i);
+}
+
+static inline uint8x16_t eqNEON(uint8x16_t c, char ch)
+{
+    return vceqq_u8(c, vdupq_n_u8((uint8_t)ch));
+}
+
+static inline uint8x16_t stringStopsNEON(uint8x16_t c)
+{
+    uint8x16_t special = vorrq_u8(vcltq_u8(c, vdupq_n_u8(0x20)), vcgeq_u8(c, vdupq_n_u8(0x80)));
+    return vorrq_u8(special, vorrq_u8(eqNEON(c, '"'), eqNEON(c, '\\')));
+}
+
+static inline uint8x16_t structuralStopsNEON(uint8x16_t c)
+{
+    uint8x16_t folded = vorrq_u8(c, vdupq_n_u8(0x20));
+    uint8x16_t brackets = vorrq_u8(eqNEON(folded, '{'), eqNEON(folded, '}'));
+    return vorrq_u8(vorrq_u8(brackets, eqNEON(c, ',')),
+                    vorrq_u8(eqNEON(c, '"'), eqNEON(c, '\\')));
+}
+
+static inline uint8x16_t asciiStopsNEON(uint8x16_t c)
+{
+    return vcgeq_u8(c, vdupq_n_u8(0x80));
+}
+
+static inline uint8x16_t escapeStopsNEON(uint8x16_t c)
+{
+    uint8x16_t control = vcltq_u8(c, vdupq_n_u8(0x20));
+    return vorrq_u8(vorrq_u8(control, eqNEON(c, 0x7f)),
+                    vorrq_u8(eqNEON(c, '"'), eqNEON(c, '\\')));
+}
+
+static size_t stringRunNEON(const char *p, size_t n)
+{
+    return runNEON<stringStopsNEON, uvStringRunScalar>(p, n);
+}
+
+static size_t structuralRunNEON(const char *p, size_t n)
+{
+    return runNEON<structuralStopsNEON, uvStructuralRunScalar>(p, n);
+}
+
+static size_t asciiRunNEON(const char *p, size_t n)
+{
+    return runNEON<asciiStopsNEON, uvAsciiRunScalar>(p, n);
+}
+
+static size_t escapeRunNEON(const char *p, size_t n)
+{
+    return runNEON<escapeStopsNEON, uvEscapeRunScalar>(p, n);
+}
+
+static size_t byteRunNEON(const char *p, size_t n, unsigned char b)
+{
+    const uint8x16_t needle = vdupq_n_u8(b);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint64_t bits = laneBits(vceqq_u8(vld1q_u8((const uint8_t *)p + i), needle));
+        if (bits)
+            return i + (__builtin_ctzll(bits) >> 2);
+    }
+    return i + uvByteRunScalar(p + i, n - i, b);
+}
+
+// Value of each digit in c, as decode16() does; bad gets the lanes that
+// are not hex digits
+static inline uint8x16_t nibblesNEON(uint8x16_t c, uint8x16_t& bad)
+{
+    uint8x16_t isDigit = vcltq_u8(vsubq_u8(c, vdupq_n_u8('0')), vdupq_n_u8(10));
+    uint8x16_t isAlpha = vcltq_u8(vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a')),
+                                  vdupq_n_u8(6));
+    bad = vorrq_u8(bad, vmvnq_u8(vorrq_u8(isDigit, isAlpha)));
+    return vaddq_u8(vandq_u8(c, vdupq_n_u8(0x0f)), vandq_u8(isAlpha, vdupq_n_u8(9)));
+}
+
+static bool hexDecodeNEON(const char *in, size_t n, uint8_t *out)
+{
+    size_t i = 0;
+    uint8x16_t bad = vdupq_n_u8(0);
+    for (; i + 16 <= n; i += 16) {
+        // de-interleaves the high and low digits of 16 bytes
+        uint8x16x2_t digits = vld2q_u8((const uint8_t *)in + 2 * i);
+        uint8x16_t high = nibblesNEON(digits.val[0], bad);
+        uint8x16_t low = nibblesNEON(digits.val[1], bad);
+        vst1q_u8(out + i, vorrq_u8(vshlq_n_u8(high, 4), low));
+    }
+    return !vmaxvq_u8(bad) && uvHexDecodeScalar(in + 2 * i, n - i, out + i);
+}
+
+static void hexEncodeNEON(const uint8_t *in, size_t n, char *out)
+{
+    const uint8x16_t table = vld1q_u8((const uint8_t *)hexDigits);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t b = vld1q_u8(in + i);
+        uint8x16x2_t digits;
+        digits.val[0] = vqtbl1q_u8(table, vshrq_n_u8(b, 4));
+        digits.val[1] = vqtbl1q_u8(table, vandq_u8(b, vdupq_n_u8(0x0f)));
+        vst2q_u8((uint8_t *)out + 2 * i, digits);
+    }
+    uvHexEncodeScalar(in + i, n - i, out + 2 * i);
+}
+
+const UniValueKernels uvKernelsNEON = {
+    CPU_NEON,
+    stringRunNEON,
+    structuralRunNEON,
+    asciiRunNEON,
+    escapeRunNEON,
+    byteRunNEON,
+    hexDecodeNEON,
+    hexEncodeNEON,
+};
+#endif // __aarch64__ && __ARM_NEON
+
+bool json_hex_decode(const char *in, size_t n, uint8_t *out)
+{
+    return uvKernels().hexDecode(in, n, out);
+}
+
+void json_hex_encode(const uint8_t *in, size_t n, char *out)
+{
+    uvKernels().hexEncode(in, n, out);
+}
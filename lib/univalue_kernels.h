@@ -0,0 +1,104 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef UNIVALUE_KERNELS_H
+#define UNIVALUE_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "univalue_cpu.h"
+
+/**
+ * The bulk byte loops, one table of them per tier.  Each run kernel
+ * returns the length of the longest prefix of p[0, n) holding none of
+ * its stop bytes, so n if there are none.
+ *
+ * The tables for tiers above the architecture's baseline are built in
+ * their own translation units, with the compiler flags for that tier.
+ * Code there must not call any inline function that another translation
+ * unit could share, such as those of the standard C++ headers, or the
+ * linker might keep the copy built with instructions that the CPU does
+ * not have.  Intrinsics and static functions are safe.
+ */
+struct UniValueKernels {
+    UniValueCPUTier tier;
+
+    // Stops at bytes a string being read cannot copy as they are:
+    // control characters, '"', '\\' and non-ASCII (to be UTF-8 checked)
+    size_t (*stringRun)(const char *p, size_t n);
+    // Stops at '"', '\\', '[', ']', '{', '}' and ','
+    size_t (*structuralRun)(const char *p, size_t n);
+    // Stops at non-ASCII bytes
+    size_t (*asciiRun)(const char *p, size_t n);
+    // Stops at bytes json_escape() replaces: control characters, '"',
+    // '\\' and DEL, as in lib/univalue_escapes.h
+    size_t (*escapeRun)(const char *p, size_t n);
+    // Stops at b
+    size_t (*byteRun)(const char *p, size_t n, unsigned char b);
+
+    // As json_hex_decode() and json_hex_encode()
+    bool (*hexDecode)(const char *in, size_t n, uint8_t *out);
+    void (*hexEncode)(const uint8_t *in, size_t n, char *out);
+};
+
+// The stop bytes of the run kernels, for the scalar kernels and for
+// callers that look at the first few bytes themselves, as a call costs
+// more than a short run
+static inline bool uvIsStringStop(unsigned char c)
+{
+    return c < 0x20 || c >= 0x80 || c == '"' || c == '\\';
+}
+
+static inline bool uvIsStructural(unsigned char c)
+{
+    return c == '"' || c == '\\' || c == '[' || c == ']' || c == '{' || c == '}' || c == ',';
+}
+
+static inline bool uvIsEscaped(unsigned char c)
+{
+    return c < 0x20 || c == '"' || c == '\\' || c == 0x7f;
+}
+
+// The scalar kernels, which the others use for their last few bytes
+size_t uvStringRunScalar(const char *p, size_t n);
+size_t uvStructuralRunScalar(const char *p, size_t n);
+size_t uvAsciiRunScalar(const char *p, size_t n);
+size_t uvEscapeRunScalar(const char *p, size_t n);
+size_t uvByteRunScalar(const char *p, size_t n, unsigned char b);
+bool uvHexDecodeScalar(const char *in, size_t n, uint8_t *out);
+void uvHexEncodeScalar(const uint8_t *in, size_t n, char *out);
+
+// One per tier; only those the build has are defined, as listed in
+// univalue_cpu.cpp.  (All are declared so that each table is defined
+// with external linkage, whatever flags its translation unit has.)
+extern const UniValueKernels uvKernelsScalar;
+extern const UniValueKernels uvKernelsSSE2;
+extern const UniValueKernels uvKernelsSSE42;
+extern const UniValueKernels uvKernelsAVX2;
+extern const UniValueKernels uvKernelsAVX512;
+extern const UniValueKernels uvKernelsNEON;
+
+#if defined(__SSE2__)
+// Also used by the tiers above that have nothing better
+size_t uvStringRunSSE2(const char *p, size_t n);
+size_t uvStructuralRunSSE2(const char *p, size_t n);
+size_t uvAsciiRunSSE2(const char *p, size_t n);
+size_t uvEscapeRunSSE2(const char *p, size_t n);
+size_t uvByteRunSSE2(const char *p, size_t n, unsigned char b);
+bool uvHexDecodeSSE2(const char *in, size_t n, uint8_t *out);
+void uvHexEncodeSSE2(const uint8_t *in, size_t n, char *out);
+#endif
+
+// The table in use.  Every table gives the same results, so a relaxed
+// load will do even while another thread switches tiers.
+extern std::atomic<const UniValueKernels *> uvActiveKernels;
+
+static inline const UniValueKernels& uvKernels()
+{
+    return *uvActiveKernels.load(std::memory_order_relaxed);
+}
+
+#endif // UNIVALUE_KERNELS_H
@@ -0,0 +1,164 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+// Kernels for AVX2, built with -mavx2; see univalue_kernels.h for what
+// code here may not do
+
+#include "univalue_kernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+// Scan 32 bytes at a time for the lanes stops() sets, then 16 with the
+// SSE2 kernel, which leaves the rest to the scalar one
+template <__m256i (*stops)(__m256i), size_t (*tail)(const char *, size_t)>
+static inline size_t runAVX2(const char *p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(stops(c));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + tail(p + i, n - i);
+}
+
+static inline __m256i eq(__m256i c, char ch)
+{
+    return _mm256_cmpeq_epi8(c, _mm256_set1_epi8(ch));
+}
+
+static inline __m256i stringStops(__m256i c)
+{
+    // a signed compare takes in both control characters and non-ASCII
+    __m256i special = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), c);
+    return _mm256_or_si256(special, _mm256_or_si256(eq(c, '"'), eq(c, '\\')));
+}
+
+static inline __m256i structuralStops(__m256i c)
+{
+    // '[' and ']' differ from '{' and '}' only in bit 5
+    __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i brackets = _mm256_or_si256(eq(folded, '{'), eq(folded, '}'));
+    return _mm256_or_si256(_mm256_or_si256(brackets, eq(c, ',')),
+                           _mm256_or_si256(eq(c, '"'), eq(c, '\\')));
+}
+
+static inline __m256i asciiStops(__m256i c)
+{
+    return c;                           // only the top bits count
+}
+
+static inline __m256i escapeStops(__m256i c)
+{
+    __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(c, _mm256_set1_epi8(0x1f)), c);
+    return _mm256_or_si256(_mm256_or_si256(control, eq(c, 0x7f)),
+                           _mm256_or_si256(eq(c, '"'), eq(c, '\\')));
+}
+
+static size_t stringRunAVX2(const char *p, size_t n)
+{
+    return runAVX2<stringStops, uvStringRunSSE2>(p, n);
+}
+
+static size_t structuralRunAVX2(const char *p, size_t n)
+{
+    return runAVX2<structuralStops, uvStructuralRunSSE2>(p, n);
+}
+
+static size_t asciiRunAVX2(const char *p, size_t n)
+{
+    return runAVX2<asciiStops, uvAsciiRunSSE2>(p, n);
+}
+
+static size_t escapeRunAVX2(const char *p, size_t n)
+{
+    return runAVX2<escapeStops, uvEscapeRunSSE2>(p, n);
+}
+
+static size_t byteRunAVX2(const char *p, size_t n, unsigned char b)
+{
+    const __m256i needle = _mm256_set1_epi8((char)b);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, needle));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + uvByteRunSSE2(p + i, n - i, b);
+}
+
+// Lanes of c whose unsigned value is in [lo, lo + n)
+static inline __m256i inRange(__m256i c, char lo, unsigned char n)
+{
+    __m256i t = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8((char)(n - 1))), t);
+}
+
+// Decode 32 digits to 16 bytes, each in the low half of a 16-bit lane;
+// ok is cleared if any digit is invalid
+static inline __m256i decode32(const char *in, unsigned int& ok)
+{
+    __m256i c = _mm256_loadu_si256((const __m256i *)in);
+    __m256i isDigit = inRange(c, '0', 10);
+    __m256i isAlpha = inRange(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 6);
+    ok &= (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) == 0xffffffff;
+
+    // '0'-'9' end in 0-9, and 'a'-'f' and 'A'-'F' in 1-6
+    __m256i nibble = _mm256_add_epi8(_mm256_and_si256(c, _mm256_set1_epi8(0x0f)),
+                                     _mm256_and_si256(isAlpha, _mm256_set1_epi8(9)));
+    __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibble, _mm256_set1_epi16(0x00ff)), 4);
+    __m256i low = _mm256_srli_epi16(nibble, 8);
+    return _mm256_or_si256(high, low);
+}
+
+static bool hexDecodeAVX2(const char *in, size_t n, uint8_t *out)
+{
+    size_t i = 0;
+    unsigned int ok = 1;
+    for (; i + 32 <= n; i += 32) {
+        __m256i first = decode32(in + 2 * i, ok);
+        __m256i second = decode32(in + 2 * i + 32, ok);
+        // packing works within each 128-bit half, so put the quarters back in order
+        __m256i packed = _mm256_packus_epi16(first, second);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    return ok && uvHexDecodeSSE2(in + 2 * i, n - i, out + i);
+}
+
+static void hexEncodeAVX2(const uint8_t *in, size_t n, char *out)
+{
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i b = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i h = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(b, 4), mask));
+        __m256i l = _mm256_shuffle_epi8(digits, _mm256_and_si256(b, mask));
+        // interleaving also works within each 128-bit half
+        __m256i lo = _mm256_unpacklo_epi8(h, l);
+        __m256i hi = _mm256_unpackhi_epi8(h, l);
+        _mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    uvHexEncodeSSE2(in + i, n - i, out + 2 * i);
+}
+
+const UniValueKernels uvKernelsAVX2 = {
+    CPU_AVX2,
+    stringRunAVX2,
+    structuralRunAVX2,
+    asciiRunAVX2,
+    escapeRunAVX2,
+    byteRunAVX2,
+    hexDecodeAVX2,
+    hexEncodeAVX2,
+};
+
+#endif // __AVX2__
@@ -0,0 +1,164 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+// Kernels for AVX-512F and AVX-512BW, built with -mavx512f -mavx512bw;
+// see univalue_kernels.h for what code here may not do
+
+#include "univalue_kernels.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+
+// Scan 64 bytes at a time for the lanes stops() sets.  The last few are
+// loaded under a mask, which does not touch the bytes past the end.
+template <__mmask64 (*stops)(__m512i)>
+static inline size_t runAVX512(const char *p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __mmask64 mask = stops(_mm512_loadu_si512(p + i));
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+    if (i < n) {
+        __mmask64 valid = (1ULL << (n - i)) - 1;
+        __mmask64 mask = stops(_mm512_maskz_loadu_epi8(valid, p + i)) & valid;
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+    return n;
+}
+
+static inline __mmask64 eq(__m512i c, char ch)
+{
+    return _mm512_cmpeq_epi8_mask(c, _mm512_set1_epi8(ch));
+}
+
+static inline __mmask64 stringStops(__m512i c)
+{
+    // a signed compare takes in both control characters and non-ASCII
+    return _mm512_cmplt_epi8_mask(c, _mm512_set1_epi8(0x20)) | eq(c, '"') | eq(c, '\\');
+}
+
+static inline __mmask64 structuralStops(__m512i c)
+{
+    // '[' and ']' differ from '{' and '}' only in bit 5
+    __m512i folded = _mm512_or_si512(c, _mm512_set1_epi8(0x20));
+    return eq(folded, '{') | eq(folded, '}') | eq(c, ',') | eq(c, '"') | eq(c, '\\');
+}
+
+static inline __mmask64 asciiStops(__m512i c)
+{
+    return _mm512_movepi8_mask(c);
+}
+
+static inline __mmask64 escapeStops(__m512i c)
+{
+    return _mm512_cmplt_epu8_mask(c, _mm512_set1_epi8(0x20)) |
+           eq(c, 0x7f) | eq(c, '"') | eq(c, '\\');
+}
+
+static size_t stringRunAVX512(const char *p, size_t n)
+{
+    return runAVX512<stringStops>(p, n);
+}
+
+static size_t structuralRunAVX512(const char *p, size_t n)
+{
+    return runAVX512<structuralStops>(p, n);
+}
+
+static size_t asciiRunAVX512(const char *p, size_t n)
+{
+    return runAVX512<asciiStops>(p, n);
+}
+
+static size_t escapeRunAVX512(const char *p, size_t n)
+{
+    return runAVX512<escapeStops>(p, n);
+}
+
+static size_t byteRunAVX512(const char *p, size_t n, unsigned char b)
+{
+    const __m512i needle = _mm512_set1_epi8((char)b);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __mmask64 mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i), needle);
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+    if (i < n) {
+        __mmask64 valid = (1ULL << (n - i)) - 1;
+        __mmask64 mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, p + i),
+                                                     needle);
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+    return n;
+}
+
+// Decode 64 digits to 32 bytes; bad gets the lanes that are not hex digits
+static inline __m256i decode64(const char *in, __mmask64& bad)
+{
+    __m512i c = _mm512_loadu_si512(in);
+    __mmask64 isDigit = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(c, _mm512_set1_epi8('0')),
+                                               _mm512_set1_epi8(10));
+    __m512i lower = _mm512_or_si512(c, _mm512_set1_epi8(0x20));
+    __mmask64 isAlpha = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(lower, _mm512_set1_epi8('a')),
+                                               _mm512_set1_epi8(6));
+    bad |= ~(isDigit | isAlpha);
+
+    // '0'-'9' end in 0-9, and 'a'-'f' and 'A'-'F' in 1-6
+    __m512i nibble = _mm512_and_si512(c, _mm512_set1_epi8(0x0f));
+    nibble = _mm512_mask_add_epi8(nibble, isAlpha, nibble, _mm512_set1_epi8(9));
+    __m512i high = _mm512_slli_epi16(_mm512_and_si512(nibble, _mm512_set1_epi16(0x00ff)), 4);
+    __m512i low = _mm512_srli_epi16(nibble, 8);
+    // narrowing each 16-bit lane keeps the bytes in order
+    return _mm512_maskz_cvtepi16_epi8(~(__mmask32)0, _mm512_or_si512(high, low));
+}
+
+static bool hexDecodeAVX512(const char *in, size_t n, uint8_t *out)
+{
+    size_t i = 0;
+    __mmask64 bad = 0;
+    for (; i + 32 <= n; i += 32)
+        _mm256_storeu_si256((__m256i *)(out + i), decode64(in + 2 * i, bad));
+    return !bad && uvHexDecodeSSE2(in + 2 * i, n - i, out + i);
+}
+
+static void hexEncodeAVX512(const uint8_t *in, size_t n, char *out)
+{
+    // "0123456789abcdef" in each 128-bit quarter
+    const __m512i digits = _mm512_set4_epi64(0x6665646362613938, 0x3736353433323130,
+                                             0x6665646362613938, 0x3736353433323130);
+    const __m512i mask = _mm512_set1_epi8(0x0f);
+    // interleaving works within each 128-bit quarter, so take the
+    // quarters of the two halves in turn
+    const __m512i first = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+    const __m512i second = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i b = _mm512_loadu_si512(in + i);
+        __m512i h = _mm512_shuffle_epi8(digits, _mm512_and_si512(_mm512_srli_epi16(b, 4), mask));
+        __m512i l = _mm512_shuffle_epi8(digits, _mm512_and_si512(b, mask));
+        __m512i lo = _mm512_unpacklo_epi8(h, l);
+        __m512i hi = _mm512_unpackhi_epi8(h, l);
+        _mm512_storeu_si512(out + 2 * i, _mm512_permutex2var_epi64(lo, first, hi));
+        _mm512_storeu_si512(out + 2 * i + 64, _mm512_permutex2var_epi64(lo, second, hi));
+    }
+    uvHexEncodeSSE2(in + i, n - i, out + 2 * i);
+}
+
+const UniValueKernels uvKernelsAVX512 = {
+    CPU_AVX512,
+    stringRunAVX512,
+    structuralRunAVX512,
+    asciiRunAVX512,
+    escapeRunAVX512,
+    byteRunAVX512,
+    hexDecodeAVX512,
+    hexEncodeAVX512,
+};
+
+#endif // __AVX512F__ && __AVX512BW__
@@ -0,0 +1,67 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+// Kernels for SSE4.2, built with -msse4.2; see univalue_kernels.h for
+// what code here may not do
+
+#include "univalue_kernels.h"
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+
+// Scan 16 bytes at a time with PCMPESTRI for any byte of set[0, setLen)
+static inline size_t runSSE42(const char *p, size_t n, const char *set, int setLen,
+                              size_t (*tail)(const char *, size_t))
+{
+    const __m128i s = _mm_loadu_si128((const __m128i *)set);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + i));
+        int at = _mm_cmpestri(s, setLen, c, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY);
+        if (at < 16)
+            return i + at;
+    }
+    return i + tail(p + i, n - i);
+}
+
+// Padded to the 16 bytes that are loaded
+static const char structuralSet[16] = { '"', '\\', '[', ']', '{', '}', ',' };
+
+static size_t structuralRunSSE42(const char *p, size_t n)
+{
+    return runSSE42(p, n, structuralSet, 7, uvStructuralRunScalar);
+}
+
+// PSHUFB looks each nibble up in a table of the digits
+static void hexEncodeSSE42(const uint8_t *in, size_t n, char *out)
+{
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i h = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(b, 4), mask));
+        __m128i l = _mm_shuffle_epi8(digits, _mm_and_si128(b, mask));
+        _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(h, l));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(h, l));
+    }
+    uvHexEncodeScalar(in + i, n - i, out + 2 * i);
+}
+
+// PCMPESTRI keeps up with the seven compares SSE2 needs for the
+// structural bytes, but not with the three or four it needs for the
+// other sets, so those stay with SSE2
+const UniValueKernels uvKernelsSSE42 = {
+    CPU_SSE42,
+    uvStringRunSSE2,
+    structuralRunSSE42,
+    uvAsciiRunSSE2,
+    uvEscapeRunSSE2,
+    uvByteRunSSE2,
+    uvHexDecodeSSE2,
+    hexEncodeSSE42,
+};
+
+#endif // __SSE4_2__
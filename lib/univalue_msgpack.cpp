@@ -0,0 +1,451 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "univalue.h"
+#include "univalue_stream.h"
+#include "univalue_format.h"
+#include "univalue_binary.h"
+#include "univalue_utffilter.h"
+
+/*
+ * MessagePack mapping:
+ *
+ *   VNULL  <-> nil
+ *   VBOOL  <-> false/true
+ *   VSTR   <-> str; strings that are not valid UTF-8 are written as bin,
+ *              which decodes as VSTR
+ *   VARR   <-> array
+ *   VOBJ   <-> map with str (or bin) keys, in insertion order
+ *   VNUM   <-> int/uint if the text is a plain integer in the 64-bit range;
+ *              float 32/64 if the text is exactly what setFloat() would
+ *              produce for that double; otherwise ext type 1 holding the
+ *              number text.
+ *
+ * Every length and integer is written in its smallest encoding.
+ */
+
+static const size_t MAX_MSGPACK_DEPTH = 512;   // same limit as read()
+static const int8_t MSGPACK_EXT_NUMSTR = 1;
+
+enum msgpack_format {
+    MP_POSFIXINT = 0x00,        // 0x00 - 0x7f
+    MP_FIXMAP = 0x80,           // 0x80 - 0x8f
+    MP_FIXARRAY = 0x90,         // 0x90 - 0x9f
+    MP_FIXSTR = 0xa0,           // 0xa0 - 0xbf
+    MP_NIL = 0xc0,
+    MP_FALSE = 0xc2,
+    MP_TRUE = 0xc3,
+    MP_BIN8 = 0xc4,
+    MP_BIN16 = 0xc5,
+    MP_BIN32 = 0xc6,
+    MP_EXT8 = 0xc7,
+    MP_EXT16 = 0xc8,
+    MP_EXT32 = 0xc9,
+    MP_FLOAT32 = 0xca,
+    MP_FLOAT64 = 0xcb,
+    MP_UINT8 = 0xcc,
+    MP_UINT16 = 0xcd,
+    MP_UINT32 = 0xce,
+    MP_UINT64 = 0xcf,
+    MP_INT8 = 0xd0,
+    MP_INT16 = 0xd1,
+    MP_INT32 = 0xd2,
+    MP_INT64 = 0xd3,
+    MP_FIXEXT1 = 0xd4,          // 0xd4 - 0xd8: fixext 1, 2, 4, 8, 16
+    MP_FIXEXT16 = 0xd8,
+    MP_STR8 = 0xd9,
+    MP_STR16 = 0xda,
+    MP_STR32 = 0xdb,
+    MP_ARRAY16 = 0xdc,
+    MP_ARRAY32 = 0xdd,
+    MP_MAP16 = 0xde,
+    MP_MAP32 = 0xdf,
+    MP_NEGFIXINT = 0xe0,        // 0xe0 - 0xff
+};
+
+namespace {
+
+class MsgPackEncoder : public BinaryWriter {
+public:
+    explicit MsgPackEncoder(UniValueSink *sink_) : BinaryWriter(sink_) {}
+
+    bool encode(const UniValue& val);
+
+private:
+    void length(unsigned char fix, size_t fixMax, unsigned char fmt8,
+                unsigned char fmt16, unsigned char fmt32, size_t n);
+    void uint(uint64_t n);
+    void sint(int64_t n);
+    void string(const std::string& s);
+    void ext(int8_t type, const std::string& data);
+    void number(const std::string& s);
+};
+
+// Length header in the smallest of the fix/8/16/32-bit forms that the
+// item type has (0 for a form that does not exist)
+void MsgPackEncoder::length(unsigned char fix, size_t fixMax, unsigned char fmt8,
+                            unsigned char fmt16, unsigned char fmt32, size_t n)
+{
+    if (fix && n <= fixMax) {
+        put(fix | n);
+    } else if (fmt8 && n <= 0xff) {
+        put(fmt8);
+        putBE(n, 1);
+    } else if (n <= 0xffff) {
+        put(fmt16);
+        putBE(n, 2);
+    } else {
+        put(fmt32);
+        putBE(n, 4);
+    }
+}
+
+void MsgPackEncoder::uint(uint64_t n)
+{
+    if (n <= 0x7f) {
+        put(n);
+    } else if (n <= 0xff) {
+        put(MP_UINT8);
+        putBE(n, 1);
+    } else if (n <= 0xffff) {
+        put(MP_UINT16);
+        putBE(n, 2);
+    } else if (n <= 0xffffffffULL) {
+        put(MP_UINT32);
+        putBE(n, 4);
+    } else {
+        put(MP_UINT64);
+        putBE(n, 8);
+    }
+}
+
+void MsgPackEncoder::sint(int64_t n)
+{
+    if (n >= 0) {
+        uint(n);
+    } else if (n >= -32) {
+        put((unsigned char)n);
+    } else if (n >= INT8_MIN) {
+        put(MP_INT8);
+        putBE((uint64_t)n, 1);
+    } else if (n >= INT16_MIN) {
+        put(MP_INT16);
+        putBE((uint64_t)n, 2);
+    } else if (n >= INT32_MIN) {
+        put(MP_INT32);
+        putBE((uint64_t)n, 4);
+    } else {
+        put(MP_INT64);
+        putBE((uint64_t)n, 8);
+    }
+}
+
+void MsgPackEncoder::string(const std::string& s)
+{
+    if (json_valid_utf8(s))
+        length(MP_FIXSTR, 31, MP_STR8, MP_STR16, MP_STR32, s.size());
+    else
+        length(0, 0, MP_BIN8, MP_BIN16, MP_BIN32, s.size());
+    buf += s;
+}
+
+void MsgPackEncoder::ext(int8_t type, const std::string& data)
+{
+    switch (data.size()) {
+    case 1: put(MP_FIXEXT1); break;
+    case 2: put(MP_FIXEXT1 + 1); break;
+    case 4: put(MP_FIXEXT1 + 2); break;
+    case 8: put(MP_FIXEXT1 + 3); break;
+    case 16: put(MP_FIXEXT16); break;
+    default:
+        length(0, 0, MP_EXT8, MP_EXT16, MP_EXT32, data.size());
+        break;
+    }
+    put((unsigned char)type);
+    buf += data;
+}
+
+void MsgPackEncoder::number(const std::string& s)
+{
+    int64_t i;
+    uint64_t u;
+    double d;
+    switch (json_classify_number(s, i, u, d)) {
+    case JNUM_INT:
+        sint(i);
+        break;
+    case JNUM_UINT:
+        uint(u);
+        break;
+    case JNUM_DOUBLE: {
+        float f = (float)d;
+        if ((double)f == d) {
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            put(MP_FLOAT32);
+            putBE(bits, 4);
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            put(MP_FLOAT64);
+            putBE(bits, 8);
+        }
+        break;
+        }
+    case JNUM_TEXT:
+        ext(MSGPACK_EXT_NUMSTR, s);
+        break;
+    }
+}
+
+bool MsgPackEncoder::encode(const UniValue& val)
+{
+    switch (val.getType()) {
+    case UniValue::VNULL:
+        put(MP_NIL);
+        break;
+    case UniValue::VBOOL:
+        put(val.isTrue() ? MP_TRUE : MP_FALSE);
+        break;
+    case UniValue::VNUM:
+        number(val.getValStr());
+        break;
+    case UniValue::VSTR:
+        string(val.getValStr());
+        break;
+    case UniValue::VARR: {
+        const std::vector<UniValue>& values = val.getValues();
+        length(MP_FIXARRAY, 15, 0, MP_ARRAY16, MP_ARRAY32, values.size());
+        for (size_t i = 0; i < values.size(); i++)
+            encode(values[i]);
+        break;
+        }
+    case UniValue::VOBJ: {
+        const std::vector<std::string>& keys = val.getKeys();
+        const std::vector<UniValue>& values = val.getValues();
+        length(MP_FIXMAP, 15, 0, MP_MAP16, MP_MAP32, keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            string(keys[i]);
+            encode(values[i]);
+        }
+        break;
+        }
+    }
+
+    maybeFlush();
+    return good();
+}
+
+class MsgPackDecoder : public BinaryReader {
+public:
+    MsgPackDecoder(const unsigned char *data, size_t len)
+        : BinaryReader(data, len) {}
+
+    bool decode(UniValue& val, size_t depth);
+
+private:
+    bool string(unsigned char fmt, std::string& s, bool& isText);
+    bool array(UniValue& val, uint64_t n, size_t depth);
+    bool map(UniValue& val, uint64_t n, size_t depth);
+    bool ext(uint64_t len, UniValue& val);
+};
+
+// Read a str or bin item, whose format byte has already been consumed
+bool MsgPackDecoder::string(unsigned char fmt, std::string& s, bool& isText)
+{
+    uint64_t len;
+    isText = true;
+    if (fmt >= MP_FIXSTR && fmt <= MP_FIXSTR + 31)
+        len = fmt & 0x1f;
+    else if (fmt == MP_STR8 || fmt == MP_STR16 || fmt == MP_STR32) {
+        if (!getBE(1 << (fmt - MP_STR8), len))
+            return false;
+    } else if (fmt == MP_BIN8 || fmt == MP_BIN16 || fmt == MP_BIN32) {
+        isText = false;
+        if (!getBE(1 << (fmt - MP_BIN8), len))
+            return false;
+    } else
+        return false;
+
+    return getBytes(len, s) && (!isText || json_valid_utf8(s));
+}
+
+bool MsgPackDecoder::array(UniValue& val, uint64_t n, size_t depth)
+{
+    if (n > remaining())                // each item is at least one byte
+        return false;
+    val.setArray();
+    val.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        UniValue item;
+        if (!decode(item, depth + 1))
+            return false;
+        val.push_back(std::move(item));
+    }
+    return true;
+}
+
+bool MsgPackDecoder::map(UniValue& val, uint64_t n, size_t depth)
+{
+    if (n > remaining() / 2)
+        return false;
+    val.setObject();
+    val.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        unsigned char fmt;
+        std::string key;
+        bool isText;
+        if (!getByte(fmt) || !string(fmt, key, isText))
+            return false;
+
+        UniValue item;
+        if (!decode(item, depth + 1))
+            return false;
+        val.__pushKV(key, std::move(item));
+    }
+    return true;
+}
+
+// Read the type byte and payload of an ext item
+bool MsgPackDecoder::ext(uint64_t len, UniValue& val)
+{
+    unsigned char type;
+    std::string data;
+    if (!getByte(type) || (int8_t)type != MSGPACK_EXT_NUMSTR || !getBytes(len, data))
+        return false;
+    return val.setNumStr(data);
+}
+
+bool MsgPackDecoder::decode(UniValue& val, size_t depth)
+{
+    if (depth > MAX_MSGPACK_DEPTH)
+        return false;
+
+    unsigned char fmt;
+    if (!getByte(fmt))
+        return false;
+
+    uint64_t n;
+    if (fmt <= 0x7f) {
+        val = UniValue(UniValue::VNUM, json_format_uint(fmt));
+        return true;
+    } else if (fmt >= MP_NEGFIXINT) {
+        val = UniValue(UniValue::VNUM, json_format_int((int8_t)fmt));
+        return true;
+    } else if (fmt >= MP_FIXMAP && fmt <= MP_FIXMAP + 15) {
+        return map(val, fmt & 0x0f, depth);
+    } else if (fmt >= MP_FIXARRAY && fmt <= MP_FIXARRAY + 15) {
+        return array(val, fmt & 0x0f, depth);
+    }
+
+    switch (fmt) {
+    case MP_NIL:
+        val.setNull();
+        return true;
+    case MP_FALSE:
+    case MP_TRUE:
+        val.setBool(fmt == MP_TRUE);
+        return true;
+
+    case MP_UINT8:
+    case MP_UINT16:
+    case MP_UINT32:
+    case MP_UINT64:
+        if (!getBE(1 << (fmt - MP_UINT8), n))
+            return false;
+        val = UniValue(UniValue::VNUM, json_format_uint(n));
+        return true;
+
+    case MP_INT8:
+    case MP_INT16:
+    case MP_INT32:
+    case MP_INT64: {
+        unsigned int bytes = 1 << (fmt - MP_INT8);
+        if (!getBE(bytes, n))
+            return false;
+        // sign-extend
+        int64_t i = (bytes == 8) ? (int64_t)n : (int64_t)(n << (64 - bytes * 8)) >> (64 - bytes * 8);
+        val = UniValue(UniValue::VNUM, json_format_int(i));
+        return true;
+        }
+
+    case MP_FLOAT32:
+    case MP_FLOAT64: {
+        double d;
+        if (fmt == MP_FLOAT32) {
+            float f;
+            uint32_t bits;
+            if (!getBE(4, n))
+                return false;
+            bits = (uint32_t)n;
+            memcpy(&f, &bits, sizeof(f));
+            d = f;
+        } else {
+            if (!getBE(8, n))
+                return false;
+            memcpy(&d, &n, sizeof(d));
+        }
+        // JSON has no representation for NaN or infinities
+        if (!isfinite(d))
+            return false;
+        return val.setFloat(d);
+        }
+
+    case MP_ARRAY16:
+    case MP_ARRAY32:
+        return getBE(fmt == MP_ARRAY16 ? 2 : 4, n) && array(val, n, depth);
+    case MP_MAP16:
+    case MP_MAP32:
+        return getBE(fmt == MP_MAP16 ? 2 : 4, n) && map(val, n, depth);
+
+    case MP_EXT8:
+    case MP_EXT16:
+    case MP_EXT32:
+        return getBE(1 << (fmt - MP_EXT8), n) && ext(n, val);
+
+    default:
+        break;
+    }
+
+    if (fmt >= MP_FIXEXT1 && fmt <= MP_FIXEXT16)
+        return ext(1 << (fmt - MP_FIXEXT1), val);
+
+    std::string s;
+    bool isText;
+    if (!string(fmt, s, isText))
+        return false;
+    val.setStr(s);
+    return true;
+}
+
+} // anon namespace
+
+std::string UniValue::writeMsgPack() const
+{
+    MsgPackEncoder enc(NULL);
+    enc.encode(*this);
+    return enc.buf;
+}
+
+bool UniValue::writeMsgPack(UniValueSink& sink) const
+{
+    MsgPackEncoder enc(&sink);
+    return enc.encode(*this) && enc.flush();
+}
+
+bool UniValue::readMsgPack(const unsigned char *data, size_t len)
+{
+    clear();
+
+    MsgPackDecoder dec(data, len);
+    if (!dec.decode(*this, 1) || !dec.atEnd()) {
+        clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "univalue.h"
+
+UniValue::Path::Path(const std::string& pointer_)
+{
+    if (!parse(pointer_))
+        throw std::runtime_error("Invalid JSON pointer: " + pointer_);
+}
+
+bool UniValue::Path::parse(const std::string& pointer_)
+{
+    pointer.clear();
+    segments.clear();
+
+    // "" is the whole document, anything else starts with '/'
+    if (pointer_.empty())
+        return true;
+    if (pointer_[0] != '/')
+        return false;
+
+    std::vector<Segment> parsed;
+    size_t pos = 1;
+    while (true) {
+        size_t next = pointer_.find('/', pos);
+        if (next == std::string::npos)
+            next = pointer_.size();
+
+        Segment seg;
+        for (size_t i = pos; i < next; i++) {
+            char ch = pointer_[i];
+            if (ch == '~') {
+                if (i + 1 >= next || (pointer_[i + 1] != '0' && pointer_[i + 1] != '1'))
+                    return false;
+                ch = (pointer_[++i] == '0') ? '~' : '/';
+            }
+            seg.key += ch;
+        }
+
+        // array indices are "0" or digits without a leading zero
+        seg.isIndex = !seg.key.empty() && (seg.key[0] != '0' || seg.key.size() == 1);
+        seg.index = 0;
+        for (size_t i = 0; seg.isIndex && i < seg.key.size(); i++) {
+            unsigned int digit = (unsigned char)seg.key[i] - '0';
+            if (digit > 9 || seg.index > (SIZE_MAX - digit) / 10)
+                seg.isIndex = false;
+            else
+                seg.index = seg.index * 10 + digit;
+        }
+
+        parsed.push_back(seg);
+        if (next == pointer_.size())
+            break;
+        pos = next + 1;
+    }
+
+    pointer = pointer_;
+    segments.swap(parsed);
+    return true;
+}
+
+// One step down the tree, or NULL if there is no such member.  Objects
+// are searched with findKey(), so that duplicate keys resolve to the first.
+const UniValue *UniValue::Path::step(const UniValue *node, const Segment& seg)
+{
+    if (node->typ == VARR) {
+        if (!seg.isIndex || seg.index >= node->values.size())
+            return NULL;
+        return &node->values[seg.index];
+    }
+
+    size_t idx;
+    if (node->typ == VOBJ && node->findKey(seg.key, idx))
+        return &node->values[idx];
+
+    return NULL;
+}
+
+const UniValue& UniValue::resolve(const Path& path) const
+{
+    const UniValue *node = this;
+    for (size_t i = 0; i < path.segments.size(); i++) {
+        const Path::Segment& seg = path.segments[i];
+        node = Path::step(node, seg);
+        if (!node)
+            return NullUniValue;
+    }
+    return *node;
+}
+
+void UniValue::resolve(const std::vector<Path>& paths, std::vector<const UniValue*>& out) const
+{
+    out.assign(paths.size(), NULL);
+
+    // Visit the paths in sorted order, so that each one shares the longest
+    // possible prefix with its predecessor, and only walk the remainder.
+    std::vector<size_t> order(paths.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&paths](size_t a, size_t b) {
+        const std::vector<Path::Segment>& sa = paths[a].segments;
+        const std::vector<Path::Segment>& sb = paths[b].segments;
+        return std::lexicographical_compare(sa.begin(), sa.end(), sb.begin(), sb.end(),
+            [](const Path::Segment& x, const Path::Segment& y) { return x.key < y.key; });
+    });
+
+    // trail[d] is the node reached by the first d segments of prev
+    std::vector<const UniValue*> trail(1, this);
+    const Path *prev = NULL;
+    for (size_t n = 0; n < order.size(); n++) {
+        const Path& path = paths[order[n]];
+
+        size_t common = 0;
+        if (prev) {
+            while (common < path.segments.size() && common + 1 < trail.size() &&
+                   prev->segments[common] == path.segments[common])
+                common++;
+        }
+        trail.resize(common + 1);
+
+        const UniValue *node = trail.back();
+        for (size_t d = common; node && d < path.segments.size(); d++) {
+            const Path::Segment& seg = path.segments[d];
+            node = Path::step(node, seg);
+            if (node)
+                trail.push_back(node);
+        }
+
+        out[order[n]] = node;
+        prev = &path;
+    }
+}
@@ -3,9 +3,17 @@
 // file COPYING or https://opensource.org/licenses/mit-license.php.
 
 #include <string.h>
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <stdio.h>
 #include "univalue.h"
+#include "univalue_format.h"
+#include "univalue_instrument.h"
+#include "univalue_kernels.h"
+#include "univalue_reader.h"
+#include "univalue_sax.h"
+#include "univalue_trace.h"
 #include "univalue_utffilter.h"
 
 /*
@@ -48,11 +56,15 @@ static const char *hatoui(const char *first, const char *last,
     return first;
 }
 
-enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
-                            const char *raw, const char *end)
+// readJsonToken() result for a string or number longer than maxString
+static const enum jtokentype JTOK_TOO_LONG = (enum jtokentype)(JTOK_ERR - 1);
+
+// Numbers and strings are built directly in tokenVal, so that a caller
+// reusing it across calls allocates only when a token outgrows it.
+static enum jtokentype readJsonToken(std::string& tokenVal, unsigned int& consumed,
+                                     const char *raw, const char *end,
+                                     size_t maxString = SIZE_MAX)
 {
-    tokenVal.clear();
-    consumed = 0;
 
     const char *rawStart = raw;
 
@@ -120,8 +132,6 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
     case '8':
     case '9': {
         // part 1: int
-        std::string numStr;
-
         const char *first = raw;
 
         const char *firstDigit = first;
@@ -130,49 +140,44 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
         if ((*firstDigit == '0') && json_isdigit(firstDigit[1]))
             return JTOK_ERR;
 
-        numStr += *raw;                       // copy first char
-        raw++;
+        raw++;                                // skip first char
 
         if ((*first == '-') && (raw < end) && (!json_isdigit(*raw)))
             return JTOK_ERR;
 
-        while (raw < end && json_isdigit(*raw)) {  // copy digits
-            numStr += *raw;
+        while (raw < end && json_isdigit(*raw)) {  // skip digits
             raw++;
         }
 
         // part 2: frac
         if (raw < end && *raw == '.') {
-            numStr += *raw;                   // copy .
-            raw++;
+            raw++;                            // skip .
 
             if (raw >= end || !json_isdigit(*raw))
                 return JTOK_ERR;
-            while (raw < end && json_isdigit(*raw)) { // copy digits
-                numStr += *raw;
+            while (raw < end && json_isdigit(*raw)) { // skip digits
                 raw++;
             }
         }
 
         // part 3: exp
         if (raw < end && (*raw == 'e' || *raw == 'E')) {
-            numStr += *raw;                   // copy E
-            raw++;
+            raw++;                            // skip E
 
-            if (raw < end && (*raw == '-' || *raw == '+')) { // copy +/-
-                numStr += *raw;
+            if (raw < end && (*raw == '-' || *raw == '+')) { // skip +/-
                 raw++;
             }
 
             if (raw >= end || !json_isdigit(*raw))
                 return JTOK_ERR;
-            while (raw < end && json_isdigit(*raw)) { // copy digits
-                numStr += *raw;
+            while (raw < end && json_isdigit(*raw)) { // skip digits
                 raw++;
             }
         }
 
-        tokenVal = numStr;
+        if ((size_t)(raw - first) > maxString)
+            return JTOK_TOO_LONG;
+        tokenVal.assign(first, raw - first);
         consumed = (raw - rawStart);
         return JTOK_NUMBER;
         }
@@ -180,12 +185,14 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
     case '"': {
         raw++;                                // skip "
 
-        std::string valStr;
-        JSONUTF8StringFilter writer(valStr);
+        JSONUTF8StringFilter writer(tokenVal);
+        const UniValueKernels& kernels = uvKernels();
 
         while (true) {
             if (raw >= end || (unsigned char)*raw < 0x20)
                 return JTOK_ERR;
+            if (tokenVal.size() > maxString)
+                return JTOK_TOO_LONG;
 
             else if (*raw == '\\') {
                 raw++;                        // skip backslash
@@ -227,15 +234,30 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
             }
 
             else {
-                writer.push_back(*raw);
-                raw++;
+                // copy up to the next byte that needs a closer look, or
+                // up to maxString, past which the loop takes a byte at a
+                // time.  Most keys are short, so the first few bytes are
+                // looked at here before calling the kernel.
+                size_t limit = std::min((size_t)(end - raw), maxString - tokenVal.size());
+                size_t run = 0;
+                while (run < limit && run < 8 && !uvIsStringStop(raw[run]))
+                    run++;
+                if (run == 8)
+                    run += kernels.stringRun(raw + run, limit - run);
+                if (run) {
+                    writer.append_ascii(raw, run);
+                    raw += run;
+                } else {
+                    writer.push_back(*raw);
+                    raw++;
+                }
             }
         }
 
         if (!writer.finalize())
             return JTOK_ERR;
-        tokenVal = valStr;
         consumed = (raw - rawStart);
+        UV_COUNT(stringBytes, consumed);
         return JTOK_STRING;
         }
 
@@ -244,6 +266,22 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
     }
 }
 
+enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
+                            const char *raw, const char *end)
+{
+    tokenVal.clear();
+    consumed = 0;
+
+    enum jtokentype tok = readJsonToken(tokenVal, consumed, raw, end);
+    if (tok == JTOK_ERR)
+        tokenVal.clear();
+    else {
+        UV_COUNT_AT(tokens, tok, 1);
+        UV_COUNT(bytesScanned, consumed);
+    }
+    return tok;
+}
+
 enum expect_bits {
     EXP_OBJ_NAME = (1U << 0),
     EXP_COLON = (1U << 1),
@@ -256,24 +294,41 @@ enum expect_bits {
 #define setExpect(bit) (expectMask |= EXP_##bit)
 #define clearExpect(bit) (expectMask &= ~EXP_##bit)
 
-bool UniValue::read(const char *raw, size_t size)
+/*
+ * The JSON grammar, shared by UniValueReader and readJsonSAX().  Each
+ * token is checked against what may follow the one before, and handed on
+ * to events, which builds whatever it builds and keeps the stack of open
+ * containers.  Events provides:
+ *
+ *   jtokentype token(tokenVal, consumed, raw, end, wantValue)
+ *                              read the next token, like getJsonToken();
+ *                              wantValue if it may be a value
+ *   size_t depth()             number of open containers
+ *   bool inObject()            whether the innermost one is an object
+ *   bool open(isObject, raw)   raw is just past the bracket
+ *   bool close(isObject)
+ *   bool key(tokenVal)
+ *   bool value(tok, tokenVal)  null, true, false, a number or a string
+ *
+ * The last four return false to stop the parse, as does token() by
+ * returning JTOK_ERR.  Returns true if exactly one value was read, with
+ * nothing but whitespace after it.
+ */
+template <class Events>
+static bool parseJson(const char *raw, const char *end, std::string& tokenVal, Events& events)
 {
-    clear();
-
     uint32_t expectMask = 0;
-    std::vector<UniValue*> stack;
-
-    std::string tokenVal;
     unsigned int consumed;
     enum jtokentype tok = JTOK_NONE;
     enum jtokentype last_tok = JTOK_NONE;
-    const char* end = raw + size;
     do {
         last_tok = tok;
 
-        tok = getJsonToken(tokenVal, consumed, raw, end);
+        bool wantValue = expect(VALUE) || expect(ARR_VALUE) || tok == JTOK_NONE;
+        consumed = 0;
+        tok = events.token(tokenVal, consumed, raw, end, wantValue);
         if (tok == JTOK_NONE || tok == JTOK_ERR)
-            goto return_fail;
+            return false;
         raw += consumed;
 
         bool isValueOpen = jsonTokenIsValue(tok) ||
@@ -281,33 +336,33 @@ bool UniValue::read(const char *raw, size_t size)
 
         if (expect(VALUE)) {
             if (!isValueOpen)
-                goto return_fail;
+                return false;
             clearExpect(VALUE);
 
         } else if (expect(ARR_VALUE)) {
             bool isArrValue = isValueOpen || (tok == JTOK_ARR_CLOSE);
             if (!isArrValue)
-                goto return_fail;
+                return false;
 
             clearExpect(ARR_VALUE);
 
         } else if (expect(OBJ_NAME)) {
             bool isObjName = (tok == JTOK_OBJ_CLOSE || tok == JTOK_STRING);
             if (!isObjName)
-                goto return_fail;
+                return false;
 
         } else if (expect(COLON)) {
             if (tok != JTOK_COLON)
-                goto return_fail;
+                return false;
             clearExpect(COLON);
 
         } else if (!expect(COLON) && (tok == JTOK_COLON)) {
-            goto return_fail;
+            return false;
         }
 
         if (expect(NOT_VALUE)) {
             if (isValueOpen)
-                goto return_fail;
+                return false;
             clearExpect(NOT_VALUE);
         }
 
@@ -315,26 +370,11 @@ bool UniValue::read(const char *raw, size_t size)
 
         case JTOK_OBJ_OPEN:
         case JTOK_ARR_OPEN: {
-            VType utyp = (tok == JTOK_OBJ_OPEN ? VOBJ : VARR);
-            if (!stack.size()) {
-                if (utyp == VOBJ)
-                    setObject();
-                else
-                    setArray();
-                stack.push_back(this);
-            } else {
-                UniValue tmpVal(utyp);
-                UniValue *top = stack.back();
-                top->values.push_back(tmpVal);
+            bool isObject = (tok == JTOK_OBJ_OPEN);
+            if (!events.open(isObject, raw))
+                return false;
 
-                UniValue *newTop = &(top->values.back());
-                stack.push_back(newTop);
-            }
-
-            if (stack.size() > MAX_JSON_DEPTH)
-                goto return_fail;
-
-            if (utyp == VOBJ)
+            if (isObject)
                 setExpect(OBJ_NAME);
             else
                 setExpect(ARR_VALUE);
@@ -343,39 +383,32 @@ bool UniValue::read(const char *raw, size_t size)
 
         case JTOK_OBJ_CLOSE:
         case JTOK_ARR_CLOSE: {
-            if (!stack.size() || (last_tok == JTOK_COMMA))
-                goto return_fail;
+            if (!events.depth() || (last_tok == JTOK_COMMA))
+                return false;
 
-            VType utyp = (tok == JTOK_OBJ_CLOSE ? VOBJ : VARR);
-            UniValue *top = stack.back();
-            if (utyp != top->getType())
-                goto return_fail;
+            bool isObject = (tok == JTOK_OBJ_CLOSE);
+            if (isObject != events.inObject() || !events.close(isObject))
+                return false;
 
-            stack.pop_back();
             clearExpect(OBJ_NAME);
             setExpect(NOT_VALUE);
             break;
             }
 
         case JTOK_COLON: {
-            if (!stack.size())
-                goto return_fail;
-
-            UniValue *top = stack.back();
-            if (top->getType() != VOBJ)
-                goto return_fail;
+            if (!events.depth() || !events.inObject())
+                return false;
 
             setExpect(VALUE);
             break;
             }
 
         case JTOK_COMMA: {
-            if (!stack.size() ||
+            if (!events.depth() ||
                 (last_tok == JTOK_COMMA) || (last_tok == JTOK_ARR_OPEN))
-                goto return_fail;
+                return false;
 
-            UniValue *top = stack.back();
-            if (top->getType() == VOBJ)
+            if (events.inObject())
                 setExpect(OBJ_NAME);
             else
                 setExpect(ARR_VALUE);
@@ -384,81 +417,638 @@ bool UniValue::read(const char *raw, size_t size)
 
         case JTOK_KW_NULL:
         case JTOK_KW_TRUE:
-        case JTOK_KW_FALSE: {
-            UniValue tmpVal;
-            switch (tok) {
-            case JTOK_KW_NULL:
-                // do nothing more
-                break;
-            case JTOK_KW_TRUE:
-                tmpVal.setBool(true);
-                break;
-            case JTOK_KW_FALSE:
-                tmpVal.setBool(false);
+        case JTOK_KW_FALSE:
+        case JTOK_NUMBER:
+        case JTOK_STRING: {
+            if (tok == JTOK_STRING && expect(OBJ_NAME)) {
+                if (!events.key(tokenVal))
+                    return false;
+                clearExpect(OBJ_NAME);
+                setExpect(COLON);
+                setExpect(NOT_VALUE);
                 break;
-            default: /* impossible */ break;
             }
 
-            if (!stack.size()) {
-                *this = tmpVal;
-                break;
+            if (!events.value(tok, tokenVal))
+                return false;
+            if (events.depth())
+                setExpect(NOT_VALUE);
+            break;
             }
 
-            UniValue *top = stack.back();
-            top->values.push_back(tmpVal);
+        default:
+            return false;
+        }
+    } while (events.depth());
 
-            setExpect(NOT_VALUE);
+    /* Check that nothing follows the initial construct (parsed above).
+     * Only whitespace may, so there is no need to tokenize what does.  */
+    while (raw < end && json_isspace(*raw))
+        raw++;
+    return raw >= end;
+}
+
+// Move val's descendants into the pool in reverse pre-order, so that
+// popping them off the back hands them out again in pre-order, which is
+// the order parse() asks for them.
+void UniValueReader::recycleChildren(UniValue& val)
+{
+    for (size_t i = val.values.size(); i-- > 0; ) {
+        UniValue& child = val.values[i];
+        recycleChildren(child);
+        child.typ = UniValue::VNULL;
+        child.val.clear();
+        child.memUsage = child.shallowUsage();
+        pool.push_back(std::move(child));
+    }
+    val.keys.clear();
+    val.values.clear();
+}
+
+void UniValueReader::recycle(UniValue& val)
+{
+    recycleChildren(val);
+    val.typ = UniValue::VNULL;
+    val.val.clear();
+    val.memUsage = val.shallowUsage();
+}
+
+void UniValueReader::release()
+{
+    std::vector<UniValue*>().swap(stack);
+    std::string().swap(tokenVal);
+    std::vector<UniValue>().swap(pool);
+    std::vector<size_t>().swap(counts);
+    std::vector<size_t>().swap(scanStack);
+}
+
+/*
+ * Most arrays and objects are small, and growing their vectors one push
+ * at a time costs an allocation per doubling.  So when one opens, look a
+ * short way ahead and count its members: if it closes within the window
+ * the count is exact, otherwise it is a lower bound.  Reserving that
+ * much costs one allocation and never over-allocates.
+ */
+static const size_t PRESIZE_WINDOW = 256;
+// Members nested deeper than this are unlikely to close within the window,
+// so stop there with a lower bound.  It also keeps deeply nested input
+// from costing a whole window at every level.
+static const size_t PRESIZE_NESTING = 4;
+
+static size_t countAhead(const char *raw, const char *end)
+{
+    if ((size_t)(end - raw) > PRESIZE_WINDOW)
+        end = raw + PRESIZE_WINDOW;
+
+    size_t depth = 0;
+    size_t count = 0;
+    bool any = false;                   // a member seen since the last ,
+    for (; raw < end; raw++) {
+        char ch = *raw;
+        if (ch == '"') {
+            // the closing quote is the first not escaped by a backslash
+            const char *quote = raw;
+            for (;;) {
+                quote = (const char *)memchr(quote + 1, '"', end - quote - 1);
+                size_t escapes = 0;
+                while (quote && quote[-1 - escapes] == '\\')
+                    escapes++;
+                if (escapes % 2 == 0)
+                    break;
+            }
+            any = true;
+            if (!quote)
+                break;
+            raw = quote;
+        } else if (ch == '[' || ch == '{') {
+            if (++depth > PRESIZE_NESTING)
+                return count + 1;
+            any = true;
+        } else if (ch == ']' || ch == '}') {
+            if (depth == 0)
+                break;
+            depth--;
+        } else if (ch == ',' && depth == 0) {
+            count++;
+            any = false;
+        } else if (!json_isspace(ch)) {
+            any = true;
+        }
+    }
+    return count + any;
+}
+
+// Length of the run before the next structural byte.  Most runs outside
+// strings are short, so look at the first few here before calling the
+// kernel.
+static inline size_t structuralRun(const UniValueKernels& kernels, const char *p, size_t n)
+{
+    size_t i = 0;
+    for (; i < n && i < 8; i++) {
+        if (uvIsStructural(p[i]))
+            return i;
+    }
+    return i + kernels.structuralRun(p + i, n - i);
+}
+
+// Count the members of every array and object in raw, in the order they
+// open.  Only brackets, commas and strings are looked at: malformed input
+// is left for the parse to reject, and at worst gets the counts wrong.
+static void countMembers(const char *raw, const char *end, std::vector<size_t>& counts,
+                         std::vector<size_t>& open)
+{
+    counts.clear();
+    open.clear();                       // indexes into counts
+    bool any = false;                   // a member seen since the last , [ or {
+    const UniValueKernels& kernels = uvKernels();
+    for (; raw < end; raw++) {
+        // skip to the next byte that can open, close or separate members
+        size_t run = structuralRun(kernels, raw, end - raw);
+        for (size_t i = 0; i < run && !any; i++)
+            any = !json_isspace(raw[i]);
+        raw += run;
+        if (raw == end)
             break;
+
+        char ch = *raw;
+        if (ch == '"') {
+            for (raw++; raw < end; raw += (*raw == '\\' ? 2 : 1)) {
+                raw += structuralRun(kernels, raw, end - raw);
+                if (raw == end || *raw == '"')
+                    break;
             }
+            if (raw >= end)
+                return;
+            any = true;
+        } else if (ch == '[' || ch == '{') {
+            open.push_back(counts.size());
+            counts.push_back(0);
+            any = false;
+        } else if (ch == ']' || ch == '}') {
+            if (open.empty())
+                return;
+            if (any)
+                counts[open.back()]++;
+            open.pop_back();
+            any = true;
+        } else if (ch == ',') {
+            if (!open.empty())
+                counts[open.back()]++;
+            any = false;
+        } else if (!json_isspace(ch)) {
+            any = true;
+        }
+    }
+}
 
-        case JTOK_NUMBER: {
-            UniValue tmpVal(VNUM, tokenVal);
-            if (!stack.size()) {
-                *this = tmpVal;
-                break;
+// Append a child of the given type to parent, reusing a pooled node, and
+// add what that costs to the running usage.  The parent's own count is
+// only brought up to date when it is closed.
+UniValue& UniValueReader::newChild(UniValue *parent, UniValue::VType type, size_t& usage)
+{
+    size_t before = parent->shallowUsage();
+    parent->values.emplace_back();
+    UniValue& child = parent->values.back();
+    if (!exact && !pool.empty()) {
+        child = std::move(pool.back());
+        pool.pop_back();
+    }
+    child.typ = type;
+    usage += parent->shallowUsage() - before + child.memUsage;
+    return child;
+}
+
+bool UniValueReader::read(const char *raw, size_t size, UniValue& out)
+{
+    if (exact) {
+        // out's old storage would not be the right size either
+        out = UniValue();
+        countMembers(raw, raw + size, counts, scanStack);
+    } else {
+        recycle(out);
+    }
+    if (!parse(raw, size, out)) {
+        if (exact)
+            out = UniValue();
+        else
+            recycle(out);
+        return false;
+    }
+    return true;
+}
+
+#ifdef UNIVALUE_USDT
+// Fire the done probes with the final figures however the parse returns
+struct ReadTrace {
+    size_t size;
+    const size_t& nodes;
+    const size_t& deepest;
+    const UniValueReadError& err;
+    ~ReadTrace() { UV_TRACE4(read__done, size, nodes, deepest, (int)err); }
+};
+
+struct SAXTrace {
+    size_t size;
+    const size_t& values;
+    const size_t& deepest;
+    const bool& ok;
+    ~SAXTrace() { UV_TRACE4(sax__done, size, values, deepest, (int)ok); }
+};
+#endif
+
+// out must be empty.  On failure err says why; anything other than
+// READ_SYNTAX is set just before returning.
+bool UniValueReader::parse(const char *raw, size_t size, UniValue& out)
+{
+    // Builds the tree for parseJson(), checking each limit as it goes
+    struct TreeEvents {
+        UniValueReader& reader;
+        UniValue& out;
+        const char *end;
+
+        // running dynamicMemoryUsage() of out, and the last value reported
+        size_t usage;
+        size_t reported;
+
+        size_t maxDepth;
+        bool timed;
+        std::chrono::steady_clock::time_point deadline;
+        size_t steps = 0;
+        size_t nodes = 0;
+        size_t containers = 0;
+        size_t deepest = 0;
+
+        TreeEvents(UniValueReader& reader_, UniValue& out_, const char *end_)
+            : reader(reader_), out(out_), end(end_), usage(out.memUsage), reported(usage),
+              maxDepth(std::min(reader.limits.maxDepth, MAX_JSON_DEPTH)),
+              timed(reader.limits.maxTime != std::chrono::steady_clock::duration::zero())
+        {
+            if (timed)
+                deadline = std::chrono::steady_clock::now() + reader.limits.maxTime;
+        }
+
+        enum jtokentype token(std::string& tokenVal, unsigned int& consumed,
+                              const char *raw, const char *end_, bool)
+        {
+            const UniValueReadLimits& limits = reader.limits;
+            tokenVal.clear();
+            enum jtokentype tok = readJsonToken(tokenVal, consumed, raw, end_, limits.maxString);
+            if (tok == JTOK_TOO_LONG) {
+                reader.err = READ_STRING;
+                return JTOK_ERR;
+            }
+            if (tok == JTOK_NONE || tok == JTOK_ERR)
+                return tok;
+            UV_COUNT_AT(tokens, tok, 1);
+            UV_COUNT(bytesScanned, consumed);
+
+            if (++steps > limits.maxSteps) {
+                reader.err = READ_STEPS;
+                return JTOK_ERR;
             }
+            // reading the clock costs more than a token, so only sample it
+            if (timed && steps % 256 == 0 && std::chrono::steady_clock::now() > deadline) {
+                reader.err = READ_TIME;
+                return JTOK_ERR;
+            }
+            return tok;
+        }
 
-            UniValue *top = stack.back();
-            top->values.push_back(tmpVal);
+        size_t depth() const { return reader.stack.size(); }
+        bool inObject() const { return reader.stack.back()->typ == UniValue::VOBJ; }
 
-            setExpect(NOT_VALUE);
-            break;
+        // Whether one more value fits, in the document and in its container
+        bool addNode()
+        {
+            const UniValueReadLimits& limits = reader.limits;
+            if (++nodes > limits.maxNodes) {
+                reader.err = READ_NODES;
+                return false;
+            }
+            if (depth() && reader.stack.back()->values.size() >= limits.maxMembers) {
+                reader.err = READ_MEMBERS;
+                return false;
             }
+            return true;
+        }
 
-        case JTOK_STRING: {
-            if (expect(OBJ_NAME)) {
-                UniValue *top = stack.back();
-                top->keys.push_back(tokenVal);
-                clearExpect(OBJ_NAME);
-                setExpect(COLON);
+        bool checkUsage()
+        {
+            if (usage == reported)
+                return true;
+            reported = usage;
+            if (usage > reader.limits.maxBytes) {
+                reader.err = READ_BYTES;
+                return false;
+            }
+            if (reader.usageCallback && !reader.usageCallback(usage)) {
+                reader.err = READ_ABORTED;
+                return false;
+            }
+            return true;
+        }
+
+        bool open(bool isObject, const char *raw)
+        {
+            if (!addNode())
+                return false;
+
+            std::vector<UniValue*>& stack = reader.stack;
+            UniValue::VType utyp = (isObject ? UniValue::VOBJ : UniValue::VARR);
+            if (!stack.size()) {
+                out.typ = utyp;
+                stack.push_back(&out);
             } else {
-                UniValue tmpVal(VSTR, tokenVal);
-                if (!stack.size()) {
-                    *this = tmpVal;
-                    break;
-                }
+                stack.push_back(&reader.newChild(stack.back(), utyp, usage));
+            }
+            deepest = std::max(deepest, stack.size());
+            UV_COUNT_AT(nodes, utyp, 1);
+
+            const std::vector<size_t>& counts = reader.counts;
+            size_t n = reader.exact ? (containers < counts.size() ? counts[containers] : 0)
+                                    : countAhead(raw, end);
+            containers++;
+            if (n) {
                 UniValue *top = stack.back();
-                top->values.push_back(tmpVal);
+                size_t before = top->shallowUsage();
+                if (utyp == UniValue::VOBJ) {
+                    top->keys.reserve(n);
+                    if (!reader.exact)          // compacted at the end instead
+                        top->val.reserve(n);
+                }
+                top->values.reserve(n);
+                usage += top->shallowUsage() - before;
             }
 
-            setExpect(NOT_VALUE);
-            break;
+            if (stack.size() > maxDepth) {
+                reader.err = READ_DEPTH;
+                return false;
             }
+            return checkUsage();
+        }
 
-        default:
-            goto return_fail;
+        bool close(bool)
+        {
+            UniValue *top = reader.stack.back();
+            if (reader.exact)
+                UniValue::compactString(top->val);      // the key tags
+            top->updateUsage();
+            UV_COUNT_AT(nodeBytes, top->typ, top->shallowUsage());
+            reader.stack.pop_back();
+            return true;
+        }
+
+        bool key(const std::string& tokenVal)
+        {
+            UniValue *top = reader.stack.back();
+            size_t before = top->shallowUsage();
+            top->keys.push_back(tokenVal);
+            top->val.push_back((char)UniValue::keyTag(tokenVal));
+            usage += top->shallowUsage() - before + UniValue::stringUsage(top->keys.back());
+            return checkUsage();
         }
-    } while (!stack.empty ());
 
-    /* Check that nothing follows the initial construct (parsed above).  */
-    tok = getJsonToken(tokenVal, consumed, raw, end);
-    if (tok != JTOK_NONE)
-        goto return_fail;
+        bool value(enum jtokentype tok, const std::string& tokenVal)
+        {
+            if (!addNode())
+                return false;
+
+            UniValue::VType utyp;
+            switch (tok) {
+            case JTOK_KW_NULL:  utyp = UniValue::VNULL; break;
+            case JTOK_NUMBER:   utyp = UniValue::VNUM; break;
+            case JTOK_STRING:   utyp = UniValue::VSTR; break;
+            default:            utyp = UniValue::VBOOL; break;
+            }
+
+            UniValue *node = &out;
+            if (depth())
+                node = &reader.newChild(reader.stack.back(), utyp, usage);
+            node->typ = utyp;
+            if (tok == JTOK_KW_TRUE)
+                node->val = "1";
+            else if (reader.exact && (utyp == UniValue::VNUM || utyp == UniValue::VSTR))
+                node->val = std::string(tokenVal);      // assign() may round up
+            else if (utyp == UniValue::VNUM || utyp == UniValue::VSTR)
+                node->val.assign(tokenVal);
+            size_t before = node->memUsage;
+            node->memUsage = node->shallowUsage();
+            usage += node->memUsage - before;
+            UV_COUNT_AT(nodes, utyp, 1);
+            UV_COUNT_AT(nodeBytes, utyp, node->memUsage);
+            return checkUsage();
+        }
+    };
+
+    stack.clear();
+    err = READ_SYNTAX;
+
+    TreeEvents events(*this, out, raw + size);
+
+    UV_TRACE2(read__start, raw, size);
+#ifdef UNIVALUE_USDT
+    ReadTrace trace = {size, events.nodes, events.deepest, err};
+#endif
 
+    if (!parseJson(raw, raw + size, tokenVal, events))
+        return false;
+    err = READ_OK;
     return true;
+}
+
+const char *uvReadErrorName(UniValueReadError e)
+{
+    switch (e) {
+    case READ_OK: return "ok";
+    case READ_SYNTAX: return "syntax";
+    case READ_DEPTH: return "depth";
+    case READ_BYTES: return "bytes";
+    case READ_NODES: return "nodes";
+    case READ_STRING: return "string";
+    case READ_MEMBERS: return "members";
+    case READ_STEPS: return "steps";
+    case READ_TIME: return "time";
+    case READ_ABORTED: return "aborted";
+    }
+
+    // not reached
+    return NULL;
+}
 
-return_fail:
+bool UniValue::read(const char *raw, size_t size)
+{
     clear();
-    return false;
+
+    UniValueReader reader;
+    if (!reader.parse(raw, size, *this)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+static const char *skipSpace(const char *raw, const char *end)
+{
+    while (raw < end && json_isspace(*raw))
+        raw++;
+    return raw;
+}
+
+/*
+ * Read a string token made only of an even number of hex digits straight
+ * into bytes, skipping the token buffer.  Anything else, escapes
+ * included, is left to getJsonToken(): returns false, consuming nothing.
+ */
+static bool readHexToken(std::vector<unsigned char>& bytes, unsigned int& consumed,
+                         const char *raw, const char *end)
+{
+    const char *start = raw;
+    raw = skipSpace(raw, end);
+    if (raw == end || *raw != '"')
+        return false;
+    raw++;
+
+    const char *close = (const char *)memchr(raw, '"', end - raw);
+    if (!close || (close - raw) % 2)
+        return false;
+    bytes.resize((close - raw) / 2);
+    if (!json_hex_decode(raw, bytes.size(), bytes.data()))
+        return false;
+
+    consumed = (close + 1 - start);
+    return true;
 }
 
+bool readJsonSAX(const char *raw, size_t size, UniValueSAXHandler& handler)
+{
+    // Delivers parseJson()'s events to handler, except where it asked to
+    // skip them
+    struct SAXEvents {
+        UniValueSAXHandler& handler;
+        std::vector<bool> stack;        // true for an object, false for an array
+
+        // skipValue: the next value is silent (onKey() returned SAX_SKIP)
+        // skipUntil: silent until the stack drops below this depth
+        bool skipValue = false;
+        size_t skipUntil = 0;
+
+        // the handler's buffer for the current token, if it is hex, and
+        // where it is decoded first, so that a string that turns out not
+        // to be hex leaves the handler's buffer alone
+        std::vector<unsigned char> *hexBytes = NULL;
+        std::vector<unsigned char> hexScratch;
+        bool isHex = false;
+
+        size_t values = 0;
+        size_t deepest = 0;
+
+        explicit SAXEvents(UniValueSAXHandler& handler_) : handler(handler_) {}
+
+        enum jtokentype token(std::string& tokenVal, unsigned int& consumed,
+                              const char *raw, const char *end, bool wantValue)
+        {
+            // A value the handler wants as bytes skips the token buffer
+            isHex = false;
+            hexBytes = NULL;
+            if (wantValue && !skipValue && !skipUntil) {
+                const char *next = skipSpace(raw, end);
+                if (next < end && *next == '"' && (hexBytes = handler.hexBuffer()) != NULL &&
+                    readHexToken(hexScratch, consumed, raw, end)) {
+                    hexBytes->swap(hexScratch);
+                    isHex = true;
+                }
+            }
+
+            if (!isHex)
+                return getJsonToken(tokenVal, consumed, raw, end);
+            UV_COUNT_AT(tokens, JTOK_STRING, 1);
+            UV_COUNT(bytesScanned, consumed);
+            UV_COUNT(stringBytes, consumed);
+            return JTOK_STRING;
+        }
+
+        size_t depth() const { return stack.size(); }
+        bool inObject() const { return stack.back(); }
+
+        bool open(bool isObject, const char *)
+        {
+            bool silent = skipValue || skipUntil;
+            values++;
+            stack.push_back(isObject);
+            if (stack.size() > MAX_JSON_DEPTH)
+                return false;
+            deepest = std::max(deepest, stack.size());
+
+            if (silent) {
+                if (!skipUntil)
+                    skipUntil = stack.size();
+                skipValue = false;
+                return true;
+            }
+            UniValueSAXHandler::Action act =
+                isObject ? handler.onBeginObject() : handler.onBeginArray();
+            if (act == UniValueSAXHandler::SAX_SKIP)
+                skipUntil = stack.size();
+            return act != UniValueSAXHandler::SAX_STOP;
+        }
+
+        bool close(bool isObject)
+        {
+            bool silent = skipValue || skipUntil;
+            stack.pop_back();
+            if (skipUntil && stack.size() < skipUntil) {
+                skipUntil = 0;
+                return true;
+            }
+            if (silent)
+                return true;
+            UniValueSAXHandler::Action act =
+                isObject ? handler.onEndObject() : handler.onEndArray();
+            return act != UniValueSAXHandler::SAX_STOP;
+        }
+
+        bool key(const std::string& tokenVal)
+        {
+            if (skipUntil)
+                return true;
+            UniValueSAXHandler::Action act = handler.onKey(tokenVal);
+            if (act == UniValueSAXHandler::SAX_SKIP)
+                skipValue = true;
+            return act != UniValueSAXHandler::SAX_STOP;
+        }
+
+        bool value(enum jtokentype tok, const std::string& tokenVal)
+        {
+            values++;
+            if (skipValue || skipUntil) {
+                skipValue = false;
+                return true;
+            }
+
+            UniValueSAXHandler::Action act;
+            if (tok == JTOK_KW_NULL)
+                act = handler.onNull();
+            else if (tok == JTOK_KW_TRUE || tok == JTOK_KW_FALSE)
+                act = handler.onBool(tok == JTOK_KW_TRUE);
+            else if (tok == JTOK_NUMBER)
+                act = handler.onNumber(tokenVal);
+            else if (isHex)
+                act = handler.onHex(*hexBytes);
+            else
+                act = handler.onString(tokenVal);
+            return act != UniValueSAXHandler::SAX_STOP;
+        }
+    };
+
+    SAXEvents events(handler);
+    bool ok = false;
+
+    UV_TRACE2(sax__start, raw, size);
+#ifdef UNIVALUE_USDT
+    SAXTrace trace = {size, events.values, events.deepest, ok};
+#endif
+
+    std::string tokenVal;
+    ok = parseJson(raw, raw + size, tokenVal, events);
+    return ok;
+}
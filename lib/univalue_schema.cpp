@@ -0,0 +1,322 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "univalue.h"
+#include "univalue_sax.h"
+#include "univalue_schema.h"
+#include "univalue_format.h"
+
+static std::string memberPath(const std::string& path, std::string_view key)
+{
+    std::string out(path);
+    if (!out.empty())
+        out += '.';
+    out.append(key.data(), key.size());
+    return out;
+}
+
+static std::string elementPath(const std::string& path, size_t index)
+{
+    return path + "[" + std::to_string(index) + "]";
+}
+
+static std::string typeError(UniValue::VType expected, const std::string& path,
+                             UniValue::VType actual)
+{
+    std::string err = "Expected type ";
+    err += uvTypeName(expected);
+    if (!path.empty())
+        err += " for " + path;
+    err += ", got ";
+    err += uvTypeName(actual);
+    return err;
+}
+
+UniValueSchema& UniValueSchema::add(std::string_view key, UniValue::VType type, bool isRequired)
+{
+    Member m;
+    m.key.assign(key.data(), key.size());
+    m.type = type;
+    m.isRequired = isRequired;
+    m.hasRange = false;
+    m.minVal = m.maxVal = 0;
+    m.hasLength = false;
+    m.minLen = m.maxLen = 0;
+
+    size_t index;
+    if (lookup(key, index)) {
+        members[index] = m;
+        last = index;
+        return *this;
+    }
+
+    last = members.size();
+    members.push_back(m);
+    std::vector<size_t>::iterator pos = std::lower_bound(sorted.begin(), sorted.end(), key,
+        [this](size_t i, std::string_view k) { return members[i].key < k; });
+    sorted.insert(pos, last);
+    return *this;
+}
+
+UniValueSchema& UniValueSchema::required(std::string_view key, UniValue::VType type)
+{
+    return add(key, type, true);
+}
+
+UniValueSchema& UniValueSchema::optional(std::string_view key, UniValue::VType type)
+{
+    return add(key, type, false);
+}
+
+UniValueSchema& UniValueSchema::range(int64_t minVal, int64_t maxVal)
+{
+    if (last < members.size()) {
+        members[last].hasRange = true;
+        members[last].minVal = minVal;
+        members[last].maxVal = maxVal;
+    }
+    return *this;
+}
+
+UniValueSchema& UniValueSchema::length(size_t minLen, size_t maxLen)
+{
+    if (last < members.size()) {
+        members[last].hasLength = true;
+        members[last].minLen = minLen;
+        members[last].maxLen = maxLen;
+    }
+    return *this;
+}
+
+UniValueSchema& UniValueSchema::nested(const UniValueSchema& schema)
+{
+    if (last < members.size())
+        members[last].schema = std::make_shared<const UniValueSchema>(schema);
+    return *this;
+}
+
+const UniValueSchema::Member *UniValueSchema::lookup(std::string_view key, size_t& index) const
+{
+    std::vector<size_t>::const_iterator pos = std::lower_bound(sorted.begin(), sorted.end(), key,
+        [this](size_t i, std::string_view k) { return members[i].key < k; });
+    if (pos == sorted.end() || members[*pos].key != key)
+        return NULL;
+    index = *pos;
+    return &members[index];
+}
+
+// Check everything but nested members; true if the type matched
+bool UniValueSchema::checkValue(const Member& m, UniValue::VType type, const std::string& text,
+                                const std::string& path, std::vector<std::string>& errors) const
+{
+    if (type != m.type) {
+        errors.push_back(typeError(m.type, path, type));
+        return false;
+    }
+
+    if (type == UniValue::VNUM && m.hasRange) {
+        int64_t n;
+        if (!json_parse_int64(text.c_str(), text.size(), &n))
+            errors.push_back("Expected integer for " + path);
+        else if (n < m.minVal || n > m.maxVal)
+            errors.push_back("Value out of range for " + path);
+    }
+
+    if (type == UniValue::VSTR && m.hasLength &&
+        (text.size() < m.minLen || text.size() > m.maxLen))
+        errors.push_back("String length out of range for " + path);
+
+    return true;
+}
+
+void UniValueSchema::checkMissing(const std::vector<bool>& seen, const std::string& path,
+                                  std::vector<std::string>& errors) const
+{
+    for (size_t i = 0; i < members.size(); i++) {
+        if (members[i].isRequired && !seen[i])
+            errors.push_back("Missing " + memberPath(path, members[i].key));
+    }
+}
+
+void UniValueSchema::validateObject(const UniValue& val, const std::string& path,
+                                    std::vector<std::string>& errors) const
+{
+    const std::vector<std::string>& keys = val.getKeys();
+    const std::vector<UniValue>& values = val.getValues();
+    std::vector<bool> seen(members.size(), false);
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        size_t index;
+        const Member *m = lookup(keys[i], index);
+        if (!m) {
+            if (unknown == REJECT_UNKNOWN)
+                errors.push_back("Unexpected key " + memberPath(path, keys[i]));
+            continue;
+        }
+
+        std::string childPath = memberPath(path, keys[i]);
+        if (seen[index]) {
+            errors.push_back("Duplicate key " + childPath);
+            continue;
+        }
+        seen[index] = true;
+
+        const UniValue& child = values[i];
+        if (!checkValue(*m, child.getType(), child.getValStr(), childPath, errors) || !m->schema)
+            continue;
+
+        if (child.isObject()) {
+            m->schema->validateObject(child, childPath, errors);
+        } else if (child.isArray()) {
+            const std::vector<UniValue>& elems = child.getValues();
+            for (size_t j = 0; j < elems.size(); j++) {
+                std::string elemPath = elementPath(childPath, j);
+                if (!elems[j].isObject())
+                    errors.push_back(typeError(UniValue::VOBJ, elemPath, elems[j].getType()));
+                else
+                    m->schema->validateObject(elems[j], elemPath, errors);
+            }
+        }
+    }
+
+    checkMissing(seen, path, errors);
+}
+
+bool UniValueSchema::validate(const UniValue& val, std::vector<std::string>& errors) const
+{
+    errors.clear();
+    if (!val.isObject())
+        errors.push_back(typeError(UniValue::VOBJ, "", val.getType()));
+    else
+        validateObject(val, "", errors);
+    return errors.empty();
+}
+
+bool UniValueSchema::validate(const UniValue& val) const
+{
+    std::vector<std::string> errors;
+    return validate(val, errors);
+}
+
+/**
+ * Event-driven counterpart of validateObject().  Each open object or
+ * array that the schema describes has a frame; everything else is
+ * skipped by the parser.
+ */
+class UniValueSchemaHandler : public UniValueSAXHandler {
+public:
+    UniValueSchemaHandler(const UniValueSchema& root_, std::vector<std::string>& errors_)
+        : root(root_), errors(errors_) {}
+
+    Action onNull() override { return value(UniValue::VNULL, ""); }
+    Action onBool(bool /* val */) override { return value(UniValue::VBOOL, ""); }
+    Action onNumber(const std::string& text) override { return value(UniValue::VNUM, text); }
+    Action onString(const std::string& str) override { return value(UniValue::VSTR, str); }
+    Action onBeginObject() override { return value(UniValue::VOBJ, ""); }
+    Action onBeginArray() override { return value(UniValue::VARR, ""); }
+
+    Action onKey(const std::string& key) override {
+        Frame& top = stack.back();
+        size_t index;
+        top.member = top.schema->lookup(key, index);
+        if (!top.member) {
+            if (top.schema->unknown == UniValueSchema::REJECT_UNKNOWN)
+                errors.push_back("Unexpected key " + memberPath(top.path, key));
+            return SAX_SKIP;
+        }
+
+        top.memberPath = memberPath(top.path, key);
+        if (top.seen[index]) {
+            errors.push_back("Duplicate key " + top.memberPath);
+            return SAX_SKIP;
+        }
+        top.seen[index] = true;
+        return SAX_OK;
+    }
+
+    Action onEndObject() override {
+        const Frame& top = stack.back();
+        top.schema->checkMissing(top.seen, top.path, errors);
+        stack.pop_back();
+        return SAX_OK;
+    }
+
+    Action onEndArray() override {
+        stack.pop_back();
+        return SAX_OK;
+    }
+
+private:
+    struct Frame {
+        const UniValueSchema *schema;
+        bool isArray;                   // array of objects valid against schema
+        std::string path;
+        std::vector<bool> seen;
+        const UniValueSchema::Member *member;  // object: described current member
+        std::string memberPath;
+        size_t count;                   // array: elements so far
+    };
+
+    const UniValueSchema& root;
+    std::vector<std::string>& errors;
+    std::vector<Frame> stack;
+
+    void push(const UniValueSchema *schema, bool isArray, const std::string& path) {
+        Frame f;
+        f.schema = schema;
+        f.isArray = isArray;
+        f.path = path;
+        if (!isArray)
+            f.seen.assign(schema->members.size(), false);
+        f.member = NULL;
+        f.count = 0;
+        stack.push_back(f);
+    }
+
+    Action value(UniValue::VType type, const std::string& text) {
+        if (stack.empty()) {
+            if (type != UniValue::VOBJ) {
+                errors.push_back(typeError(UniValue::VOBJ, "", type));
+                return SAX_SKIP;
+            }
+            push(&root, false, "");
+            return SAX_OK;
+        }
+
+        Frame& top = stack.back();
+        if (top.isArray) {
+            std::string elemPath = elementPath(top.path, top.count++);
+            if (type != UniValue::VOBJ) {
+                errors.push_back(typeError(UniValue::VOBJ, elemPath, type));
+                return SAX_SKIP;
+            }
+            push(top.schema, false, elemPath);
+            return SAX_OK;
+        }
+
+        const UniValueSchema::Member *m = top.member;
+        std::string path = top.memberPath;
+        if (!top.schema->checkValue(*m, type, text, path, errors) || !m->schema)
+            return SAX_SKIP;
+        if (type == UniValue::VOBJ || type == UniValue::VARR)
+            push(m->schema.get(), type == UniValue::VARR, path);
+        return SAX_OK;
+    }
+};
+
+bool UniValueSchema::validateJSON(const char *raw, size_t size,
+                                  std::vector<std::string>& errors) const
+{
+    errors.clear();
+    UniValueSchemaHandler handler(*this, errors);
+    if (!readJsonSAX(raw, size, handler)) {
+        errors.assign(1, "Parse error");
+        return false;
+    }
+    return errors.empty();
+}
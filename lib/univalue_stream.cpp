@@ -0,0 +1,225 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <math.h>
+#include "univalue.h"
+#include "univalue_stream.h"
+#include "univalue_format.h"
+
+// Buffered output is handed to the sink once it grows beyond this
+static const size_t STREAM_FLUSH_SIZE = 64 * 1024;
+
+UniValueWriter::UniValueWriter(UniValueSink& sink_, unsigned int prettyIndent_,
+                               unsigned int indentLevel_)
+    : sink(sink_), prettyIndent(prettyIndent_), indentLevel(indentLevel_),
+      modIndent(indentLevel_ ? indentLevel_ : 1), done(false), error(false)
+{
+}
+
+UniValueWriter::~UniValueWriter()
+{
+    flush();
+}
+
+// Emit the separator and indentation that precede a value, and check
+// that a value is allowed here.
+bool UniValueWriter::beginValue()
+{
+    if (error)
+        return false;
+
+    if (stack.empty()) {
+        if (done)
+            return fail();
+        return true;
+    }
+
+    Frame& top = stack.back();
+    if (top.isObject) {
+        if (!top.haveKey)
+            return fail();
+        top.haveKey = false;
+        return true;
+    }
+
+    if (top.count > 0) {
+        buf += ",";
+        if (prettyIndent)
+            buf += "\n";
+    }
+    if (prettyIndent)
+        indent(modIndent + stack.size() - 1);
+    top.count++;
+    return true;
+}
+
+bool UniValueWriter::endValue()
+{
+    if (stack.empty())
+        done = true;
+    if (buf.size() >= STREAM_FLUSH_SIZE)
+        return flush();
+    return true;
+}
+
+bool UniValueWriter::beginContainer(bool isObject)
+{
+    if (!beginValue())
+        return false;
+
+    buf += (isObject ? "{" : "[");
+    if (prettyIndent)
+        buf += "\n";
+
+    Frame frame;
+    frame.isObject = isObject;
+    frame.haveKey = false;
+    frame.count = 0;
+    stack.push_back(frame);
+    return true;
+}
+
+bool UniValueWriter::endContainer(bool isObject)
+{
+    if (error)
+        return false;
+    if (stack.empty() || stack.back().isObject != isObject || stack.back().haveKey)
+        return fail();
+
+    if (prettyIndent) {
+        if (stack.back().count > 0)
+            buf += "\n";
+        indent(modIndent + stack.size() - 2);
+    }
+    buf += (isObject ? "}" : "]");
+
+    stack.pop_back();
+    return endValue();
+}
+
+bool UniValueWriter::beginObject() { return beginContainer(true); }
+bool UniValueWriter::endObject() { return endContainer(true); }
+bool UniValueWriter::beginArray() { return beginContainer(false); }
+bool UniValueWriter::endArray() { return endContainer(false); }
+
+bool UniValueWriter::key(std::string_view k)
+{
+    if (error)
+        return false;
+    if (stack.empty() || !stack.back().isObject || stack.back().haveKey)
+        return fail();
+
+    Frame& top = stack.back();
+    if (top.count > 0) {
+        buf += ",";
+        if (prettyIndent)
+            buf += "\n";
+    }
+    if (prettyIndent)
+        indent(modIndent + stack.size() - 1);
+    buf += "\"";
+    json_escape(k.data(), k.size(), buf);
+    buf += "\":";
+    if (prettyIndent)
+        buf += " ";
+
+    top.haveKey = true;
+    top.count++;
+    return true;
+}
+
+bool UniValueWriter::writeScalar(const std::string& text)
+{
+    if (!beginValue())
+        return false;
+    buf += text;
+    return endValue();
+}
+
+bool UniValueWriter::value(const UniValue& val)
+{
+    if (!beginValue())
+        return false;
+    if (stack.empty())
+        buf += val.write(prettyIndent, indentLevel);
+    else
+        buf += val.write(prettyIndent, modIndent + stack.size());
+    return endValue();
+}
+
+bool UniValueWriter::valueNull()
+{
+    return writeScalar("null");
+}
+
+bool UniValueWriter::value(bool val)
+{
+    return writeScalar(val ? "true" : "false");
+}
+
+bool UniValueWriter::value(int64_t val)
+{
+    return writeScalar(json_format_int(val));
+}
+
+bool UniValueWriter::value(uint64_t val)
+{
+    return writeScalar(json_format_uint(val));
+}
+
+bool UniValueWriter::value(double val)
+{
+    if (!isfinite(val))
+        return fail();
+    return writeScalar(json_format_float(val));
+}
+
+bool UniValueWriter::valueNumStr(const std::string& val)
+{
+    UniValue num;
+    if (!num.setNumStr(val))
+        return fail();
+    return writeScalar(val);
+}
+
+bool UniValueWriter::value(std::string_view val)
+{
+    if (!beginValue())
+        return false;
+    buf += "\"";
+    json_escape(val.data(), val.size(), buf);
+    buf += "\"";
+    return endValue();
+}
+
+bool UniValueWriter::valueHex(const uint8_t *data, size_t size)
+{
+    if (!beginValue())
+        return false;
+    size_t start = buf.size() + 1;
+    buf.resize(start + 2 * size + 1, '"');
+    buf[start - 1] = '"';
+    json_hex_encode(data, size, &buf[start]);
+    return endValue();
+}
+
+bool UniValueWriter::flush()
+{
+    if (!buf.empty()) {
+        bool ok = sink.write(buf.data(), buf.size());
+        buf.clear();
+        if (!ok)
+            error = true;
+    }
+    if (!sink.flush())
+        error = true;
+    return !error;
+}
+
+bool UniValueWriter::finish()
+{
+    if (!done || !stack.empty())
+        error = true;
+    return flush();
+}
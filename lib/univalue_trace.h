@@ -0,0 +1,31 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef UNIVALUE_TRACE_H
+#define UNIVALUE_TRACE_H
+
+// Statically defined tracepoints, compiled in with ./configure
+// --enable-usdt.  Each is a nop in the code until a tracer such as
+// bpftrace attaches to it; contrib/univalue.bt lists them and their
+// arguments.  Without the option they compile to nothing at all.
+
+#ifdef UNIVALUE_USDT
+
+#include <sys/sdt.h>
+
+#define UV_TRACE1(name, a) DTRACE_PROBE1(univalue, name, a)
+#define UV_TRACE2(name, a, b) DTRACE_PROBE2(univalue, name, a, b)
+#define UV_TRACE3(name, a, b, c) DTRACE_PROBE3(univalue, name, a, b, c)
+#define UV_TRACE4(name, a, b, c, d) DTRACE_PROBE4(univalue, name, a, b, c, d)
+
+#else
+
+#define UV_TRACE1(name, a) ((void)0)
+#define UV_TRACE2(name, a, b) ((void)0)
+#define UV_TRACE3(name, a, b, c) ((void)0)
+#define UV_TRACE4(name, a, b, c, d) ((void)0)
+
+#endif // UNIVALUE_USDT
+
+#endif // UNIVALUE_TRACE_H
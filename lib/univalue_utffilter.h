@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "univalue_kernels.h"
+
 /**
  * Filter that generates and validates UTF-8, as well as collates UTF-16
  * surrogate pairs as specified in RFC4627.
@@ -45,6 +47,21 @@ public:
                 push_back_u(codepoint);
         }
     }
+    // Write a run of 7-bit ASCII, as push_back() would one at a time
+    void append_ascii(const char *s, size_t n)
+    {
+        if (state == 0)
+            str.append(s, n);
+        else
+            for (size_t i = 0; i < n; i++)
+                push_back(s[i]);
+    }
+    // Whether the bytes so far end on a character boundary, where ASCII
+    // would be passed through
+    bool at_boundary() const
+    {
+        return state == 0;
+    }
     // Write codepoint directly, possibly collating surrogate pairs
     void push_back_u(unsigned int codepoint_)
     {
@@ -116,4 +133,23 @@ private:
     }
 };
 
+// Check that s is well-formed UTF-8, skipping runs of ASCII between
+// sequences
+static inline bool json_valid_utf8(const std::string& s)
+{
+    const UniValueKernels& kernels = uvKernels();
+    size_t i = kernels.asciiRun(s.data(), s.size());
+    if (i == s.size())
+        return true;
+
+    std::string scratch;
+    JSONUTF8StringFilter filter(scratch);
+    while (i < s.size()) {
+        filter.push_back(s[i++]);
+        if (filter.at_boundary())
+            i += kernels.asciiRun(s.data() + i, s.size() - i);
+    }
+    return filter.finalize();
+}
+
 #endif
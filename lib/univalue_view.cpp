@@ -0,0 +1,409 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+#include <string>
+#include "univalue.h"
+#include "univalue_view.h"
+#include "univalue_format.h"
+
+/*
+ * Snapshot layout.  All integers are 32-bit little-endian, all offsets are
+ * from the start of the snapshot, and every node starts 4-byte aligned.
+ *
+ *   header:  "UVS\x01"  total-size  root-offset  reserved(0)
+ *
+ *   node:    tag = (n << 3) | VType, followed by
+ *     VNULL  nothing
+ *     VBOOL  nothing; n is 0 or 1
+ *     VSTR   n bytes of text, a NUL, padding
+ *     VNUM   n bytes of number text, a NUL, padding
+ *     VARR   n child offsets
+ *     VOBJ   n (key offset, value offset) pairs; keys are VSTR nodes
+ */
+
+static const unsigned char SNAPSHOT_MAGIC[4] = { 'U', 'V', 'S', 0x01 };
+static const size_t SNAPSHOT_HEADER_SIZE = 16;
+static const uint32_t SNAPSHOT_MAX_COUNT = 0x1fffffff;
+static const unsigned int MAX_SNAPSHOT_DEPTH = 512;    // same limit as read()
+
+static void putLE32(std::string& out, uint32_t n)
+{
+    out += (char)(n & 0xff);
+    out += (char)((n >> 8) & 0xff);
+    out += (char)((n >> 16) & 0xff);
+    out += (char)((n >> 24) & 0xff);
+}
+
+static void patchLE32(std::string& out, size_t pos, uint32_t n)
+{
+    for (int i = 0; i < 4; i++)
+        out[pos + i] = (char)((n >> (8 * i)) & 0xff);
+}
+
+static uint32_t writeText(std::string& out, UniValue::VType type, const std::string& str)
+{
+    out.append((4 - out.size() % 4) % 4, '\0');
+    size_t off = out.size();
+    if (str.size() > SNAPSHOT_MAX_COUNT || off > UINT32_MAX)
+        return 0;
+
+    putLE32(out, (uint32_t)(str.size() << 3) | type);
+    out += str;
+    out += '\0';
+    return (uint32_t)off;
+}
+
+// Append the node for val, return its offset (or 0 if it does not fit)
+static uint32_t writeNode(std::string& out, const UniValue& val)
+{
+    UniValue::VType type = val.getType();
+    if (type == UniValue::VSTR || type == UniValue::VNUM)
+        return writeText(out, type, val.getValStr());
+
+    out.append((4 - out.size() % 4) % 4, '\0');
+    size_t off = out.size();
+
+    size_t n = 0;
+    if (type == UniValue::VBOOL)
+        n = val.isTrue() ? 1 : 0;
+    else if (type == UniValue::VARR || type == UniValue::VOBJ)
+        n = val.size();
+    if (n > SNAPSHOT_MAX_COUNT || off > UINT32_MAX)
+        return 0;
+    putLE32(out, (uint32_t)(n << 3) | type);
+
+    switch (type) {
+    case UniValue::VNULL:
+    case UniValue::VBOOL:
+    case UniValue::VSTR:
+    case UniValue::VNUM:
+        break;
+
+    case UniValue::VARR: {
+        const std::vector<UniValue>& values = val.getValues();
+        size_t table = out.size();
+        out.append(4 * n, '\0');
+        for (size_t i = 0; i < n; i++) {
+            uint32_t childOff = writeNode(out, values[i]);
+            if (!childOff)
+                return 0;
+            patchLE32(out, table + 4 * i, childOff);
+        }
+        break;
+        }
+
+    case UniValue::VOBJ: {
+        const std::vector<std::string>& keys = val.getKeys();
+        const std::vector<UniValue>& values = val.getValues();
+        size_t table = out.size();
+        out.append(8 * n, '\0');
+        for (size_t i = 0; i < n; i++) {
+            uint32_t keyOff = writeText(out, UniValue::VSTR, keys[i]);
+            uint32_t childOff = keyOff ? writeNode(out, values[i]) : 0;
+            if (!childOff)
+                return 0;
+            patchLE32(out, table + 8 * i, keyOff);
+            patchLE32(out, table + 8 * i + 4, childOff);
+        }
+        break;
+        }
+    }
+
+    return (uint32_t)off;
+}
+
+bool UniValue::writeSnapshot(std::string& out) const
+{
+    out.clear();
+    out.append((const char *)SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out.append(SNAPSHOT_HEADER_SIZE - sizeof(SNAPSHOT_MAGIC), '\0');
+
+    uint32_t root = writeNode(out, *this);
+    if (!root || out.size() > UINT32_MAX) {
+        out.clear();
+        return false;
+    }
+    patchLE32(out, 4, (uint32_t)out.size());
+    patchLE32(out, 8, root);
+    return true;
+}
+
+bool UniValueView::open(const void *data, size_t len, UniValueView& root)
+{
+    UniValueView snap((const unsigned char *)data, len, 0);
+    uint32_t total, rootOff;
+    if (len < SNAPSHOT_HEADER_SIZE ||
+        memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        !snap.readU32(4, total) || total != len ||
+        !snap.readU32(8, rootOff) || rootOff < SNAPSHOT_HEADER_SIZE)
+        return false;
+
+    root = UniValueView(snap.base, len, rootOff);
+    return true;
+}
+
+bool UniValueView::readU32(size_t pos, uint32_t& n) const
+{
+    if (!base || pos > len || len - pos < 4)
+        return false;
+    const unsigned char *p = base + pos;
+    n = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    return true;
+}
+
+bool UniValueView::tag(UniValue::VType& type, uint32_t& n) const
+{
+    uint32_t t;
+    if (!readU32(off, t) || (t & 7) > UniValue::VBOOL)
+        return false;
+    type = (UniValue::VType)(t & 7);
+    n = t >> 3;
+
+    // make sure whatever follows the tag is inside the buffer
+    size_t body = 0;
+    if (type == UniValue::VSTR || type == UniValue::VNUM)
+        body = (size_t)n + 1;
+    else if (type == UniValue::VARR)
+        body = 4 * (size_t)n;
+    else if (type == UniValue::VOBJ)
+        body = 8 * (size_t)n;
+    return len - off - 4 >= body;
+}
+
+bool UniValueView::text(const char *& str, uint32_t& n) const
+{
+    UniValue::VType type;
+    if (!tag(type, n) || (type != UniValue::VSTR && type != UniValue::VNUM))
+        return false;
+    str = (const char *)base + off + 4;
+    return str[n] == '\0';
+}
+
+// The node whose offset is stored at pos
+UniValueView UniValueView::child(size_t pos) const
+{
+    uint32_t childOff;
+    if (!readU32(pos, childOff) || childOff < SNAPSHOT_HEADER_SIZE)
+        return UniValueView();
+    return UniValueView(base, len, childOff);
+}
+
+UniValue::VType UniValueView::getType() const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n))
+        return UniValue::VNULL;
+    return type;
+}
+
+bool UniValueView::isTrue() const
+{
+    UniValue::VType type;
+    uint32_t n;
+    return tag(type, n) && type == UniValue::VBOOL && n == 1;
+}
+
+size_t UniValueView::size() const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n) || (type != UniValue::VARR && type != UniValue::VOBJ))
+        return 0;
+    return n;
+}
+
+UniValueView UniValueView::operator[](size_t index) const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n) || index >= n)
+        return UniValueView();
+    if (type == UniValue::VARR)
+        return child(off + 4 + 4 * index);
+    if (type == UniValue::VOBJ)
+        return child(off + 4 + 8 * index + 4);
+    return UniValueView();
+}
+
+std::string_view UniValueView::key(size_t index) const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n) || type != UniValue::VOBJ || index >= n)
+        return std::string_view();
+    return child(off + 4 + 8 * index).getValStr();
+}
+
+UniValueView UniValueView::operator[](std::string_view k) const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n) || type != UniValue::VOBJ)
+        return UniValueView();
+
+    for (size_t i = 0; i < n; i++) {
+        const char *str;
+        uint32_t keyLen;
+        UniValueView keyView = child(off + 4 + 8 * i);
+        if (keyView.text(str, keyLen) && k == std::string_view(str, keyLen))
+            return child(off + 4 + 8 * i + 4);
+    }
+    return UniValueView();
+}
+
+bool UniValueView::exists(std::string_view k) const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (!tag(type, n) || type != UniValue::VOBJ)
+        return false;
+
+    for (size_t i = 0; i < n; i++) {
+        if (key(i) == k)
+            return true;
+    }
+    return false;
+}
+
+std::string_view UniValueView::getValStr() const
+{
+    const char *str;
+    uint32_t n;
+    if (!text(str, n))
+        return std::string_view();
+    return std::string_view(str, n);
+}
+
+bool UniValueView::get_bool() const
+{
+    if (getType() != UniValue::VBOOL)
+        throw std::runtime_error("JSON value is not a boolean as expected");
+    return isTrue();
+}
+
+std::string_view UniValueView::get_str() const
+{
+    if (getType() != UniValue::VSTR)
+        throw std::runtime_error("JSON value is not a string as expected");
+    return getValStr();
+}
+
+int UniValueView::get_int() const
+{
+    const char *str;
+    uint32_t n;
+    if (getType() != UniValue::VNUM || !text(str, n))
+        throw std::runtime_error("JSON value is not an integer as expected");
+    int32_t retval;
+    if (!json_parse_int32(str, n, &retval))
+        throw std::runtime_error("JSON integer out of range");
+    return retval;
+}
+
+int64_t UniValueView::get_int64() const
+{
+    const char *str;
+    uint32_t n;
+    if (getType() != UniValue::VNUM || !text(str, n))
+        throw std::runtime_error("JSON value is not an integer as expected");
+    int64_t retval;
+    if (!json_parse_int64(str, n, &retval))
+        throw std::runtime_error("JSON integer out of range");
+    return retval;
+}
+
+double UniValueView::get_real() const
+{
+    const char *str;
+    uint32_t n;
+    if (getType() != UniValue::VNUM || !text(str, n))
+        throw std::runtime_error("JSON value is not a number as expected");
+    double retval;
+    if (!json_parse_double(str, n, &retval))
+        throw std::runtime_error("JSON double out of range");
+    return retval;
+}
+
+// Take n bytes from budget, or fail if there are not that many left
+static bool charge(size_t& budget, size_t n)
+{
+    if (n > budget)
+        return false;
+    budget -= n;
+    return true;
+}
+
+bool UniValueView::toUniValue(UniValue& val) const
+{
+    // A snapshot written by writeSnapshot() stores each node once, so the
+    // nodes a copy visits, text included, add up to no more than the
+    // snapshot's size.  A corrupt snapshot whose nodes are shared could
+    // make the copy far larger, and take exponential time to make.
+    size_t budget = len;
+    val.clear();
+    if (!toUniValue(val, 1, budget)) {
+        val.clear();
+        return false;
+    }
+    return true;
+}
+
+bool UniValueView::toUniValue(UniValue& val, unsigned int depth, size_t& budget) const
+{
+    UniValue::VType type;
+    uint32_t n;
+    if (depth > MAX_SNAPSHOT_DEPTH || !tag(type, n) || !charge(budget, 4))
+        return false;
+
+    switch (type) {
+    case UniValue::VNULL:
+        val.setNull();
+        return true;
+    case UniValue::VBOOL:
+        val.setBool(n == 1);
+        return true;
+    case UniValue::VSTR:
+    case UniValue::VNUM: {
+        const char *str;
+        if (!text(str, n) || !charge(budget, (size_t)n + 1))
+            return false;
+        val = UniValue(type, std::string(str, n));
+        return true;
+        }
+    case UniValue::VARR:
+        if (!charge(budget, 4 * (size_t)n))
+            return false;
+        val.setArray();
+        val.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            UniValue item;
+            if (!child(off + 4 + 4 * i).toUniValue(item, depth + 1, budget))
+                return false;
+            val.push_back(std::move(item));
+        }
+        return true;
+    case UniValue::VOBJ:
+        if (!charge(budget, 8 * (size_t)n))
+            return false;
+        val.setObject();
+        val.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            const char *str;
+            uint32_t keyLen;
+            UniValue item;
+            if (!child(off + 4 + 8 * i).text(str, keyLen) ||
+                !charge(budget, 4 + (size_t)keyLen + 1) ||
+                !child(off + 4 + 8 * i + 4).toUniValue(item, depth + 1, budget))
+                return false;
+            val.__pushKV(std::string(str, keyLen), std::move(item));
+        }
+        return true;
+    }
+
+    return false;
+}
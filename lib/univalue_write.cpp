@@ -4,33 +4,74 @@
 
 #include <iomanip>
 #include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include "univalue.h"
 #include "univalue_escapes.h"
-
-static std::string json_escape(const std::string& inS)
+#include "univalue_format.h"
+#include "univalue_instrument.h"
+#include "univalue_kernels.h"
+#include "univalue_trace.h"
+
+// Containers with fewer members than this are not worth splitting up
+// for writeParallel().
+static const size_t PARALLEL_WRITE_MIN = 1024;
+// Split into more chunks than threads, so that uneven members balance out.
+static const size_t PARALLEL_WRITE_CHUNKS_PER_THREAD = 4;
+
+void json_escape(const char *in, size_t len, std::string& outS)
 {
-    std::string outS;
-    outS.reserve(inS.size() * 2);
-
-    for (unsigned int i = 0; i < inS.size(); i++) {
-        unsigned char ch = inS[i];
-        const char *escStr = escapes[ch];
-
-        if (escStr)
+    const UniValueKernels& kernels = uvKernels();
+    size_t i = 0;
+    while (i < len) {
+        const char *escStr = escapes[(unsigned char)in[i]];
+        if (escStr) {
             outS += escStr;
-        else
-            outS += ch;
+            i++;
+        } else if (i + 1 == len || escapes[(unsigned char)in[i + 1]]) {
+            // a lone byte between escapes is not worth a scan
+            outS += in[i++];
+        } else {
+            // copy up to the next byte that needs escaping
+            size_t run = kernels.escapeRun(in + i, len - i);
+            outS.append(in + i, run);
+            i += run;
+        }
     }
+}
 
-    return outS;
+void json_escape(const std::string& inS, std::string& outS)
+{
+    json_escape(inS.data(), inS.size(), outS);
 }
 
 std::string UniValue::write(unsigned int prettyIndent,
                             unsigned int indentLevel) const
 {
+    UV_TRACE3(write__start, (int)typ, values.size(), prettyIndent);
+
     std::string s;
     s.reserve(1024);
+    writeValue(prettyIndent, indentLevel, s);
+
+    UV_COUNT(writeCalls, 1);
+    UV_COUNT(writeBytes, s.size());
+    UV_COUNT(writeGrowth, s.capacity() > 1024);
+
+    UV_TRACE2(write__done, s.data(), s.size());
+    return s;
+}
 
+// Append this value to s.  Members are appended in place rather than
+// written separately and copied up, which would copy the text of a
+// deeply nested value once per level.
+void UniValue::writeValue(unsigned int prettyIndent, unsigned int indentLevel,
+                          std::string& s) const
+{
     unsigned int modIndent = indentLevel;
     if (modIndent == 0)
         modIndent = 1;
@@ -46,7 +87,9 @@ std::string UniValue::write(unsigned int prettyIndent,
         writeArray(prettyIndent, modIndent, s);
         break;
     case VSTR:
-        s += "\"" + json_escape(val) + "\"";
+        s += "\"";
+        json_escape(val, s);
+        s += "\"";
         break;
     case VNUM:
         s += val;
@@ -55,8 +98,6 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += (val == "1" ? "true" : "false");
         break;
     }
-
-    return s;
 }
 
 static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::string& s)
@@ -70,16 +111,7 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
     if (prettyIndent)
         s += "\n";
 
-    for (unsigned int i = 0; i < values.size(); i++) {
-        if (prettyIndent)
-            indentStr(prettyIndent, indentLevel, s);
-        s += values[i].write(prettyIndent, indentLevel + 1);
-        if (i != (values.size() - 1)) {
-            s += ",";
-        }
-        if (prettyIndent)
-            s += "\n";
-    }
+    writeRange(prettyIndent, indentLevel, 0, values.size(), 1, s);
 
     if (prettyIndent)
         indentStr(prettyIndent, indentLevel - 1, s);
@@ -92,21 +124,115 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     if (prettyIndent)
         s += "\n";
 
-    for (unsigned int i = 0; i < keys.size(); i++) {
+    writeRange(prettyIndent, indentLevel, 0, keys.size(), 1, s);
+
+    if (prettyIndent)
+        indentStr(prettyIndent, indentLevel - 1, s);
+    s += "}";
+}
+
+// Write members [first, last) of an array or object, including the
+// separators that follow them.  Children are written with writeParallel()
+// when nThreads > 1.
+void UniValue::writeRange(unsigned int prettyIndent, unsigned int indentLevel,
+                          size_t first, size_t last, unsigned int nThreads, std::string& s) const
+{
+    for (size_t i = first; i < last; i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += "\"" + json_escape(keys[i]) + "\":";
-        if (prettyIndent)
-            s += " ";
-        s += values.at(i).write(prettyIndent, indentLevel + 1);
+        if (typ == VOBJ) {
+            s += "\"";
+            json_escape(keys[i], s);
+            s += "\":";
+            if (prettyIndent)
+                s += " ";
+        }
+        if (nThreads > 1)
+            s += values.at(i).writeParallel(prettyIndent, indentLevel + 1, nThreads);
+        else
+            values.at(i).writeValue(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1))
             s += ",";
         if (prettyIndent)
             s += "\n";
     }
+}
+
+std::string UniValue::writeParallel(unsigned int prettyIndent,
+                                    unsigned int indentLevel,
+                                    unsigned int nThreads) const
+{
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+    if (nThreads <= 1 || (typ != VOBJ && typ != VARR))
+        return write(prettyIndent, indentLevel);
+
+    unsigned int modIndent = indentLevel;
+    if (modIndent == 0)
+        modIndent = 1;
 
+    std::string s;
+    s += (typ == VOBJ ? "{" : "[");
     if (prettyIndent)
-        indentStr(prettyIndent, indentLevel - 1, s);
-    s += "}";
-}
+        s += "\n";
+
+    size_t n = values.size();
+    if (n < PARALLEL_WRITE_MIN) {
+        // Too small to split; a large container may still be nested below.
+        writeRange(prettyIndent, modIndent, 0, n, nThreads, s);
+    } else {
+        size_t nChunks = nThreads * PARALLEL_WRITE_CHUNKS_PER_THREAD;
+        size_t chunkSize = (n + nChunks - 1) / nChunks;
+        nChunks = (n + chunkSize - 1) / chunkSize;
+
+        std::vector<std::string> chunks(nChunks);
+        std::atomic<size_t> nextChunk(0);
+        std::exception_ptr error;
+        std::mutex errorLock;
+        auto worker = [&]() {
+            try {
+                size_t c;
+                while ((c = nextChunk++) < nChunks) {
+                    size_t first = c * chunkSize;
+                    size_t last = std::min(first + chunkSize, n);
+                    writeRange(prettyIndent, modIndent, first, last, 1, chunks[c]);
+                }
+            } catch (...) {
+                // Keep the first failure for the caller; the others stop
+                // at their next chunk
+                std::lock_guard<std::mutex> lock(errorLock);
+                if (!error)
+                    error = std::current_exception();
+                nextChunk = nChunks;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(std::min<size_t>(nThreads, nChunks));
+        try {
+            for (unsigned int i = 1; i < nThreads && i < nChunks; i++)
+                workers.emplace_back(worker);
+        } catch (const std::system_error&) {
+            // Out of threads: the ones already started and this one share
+            // the chunks between them
+        }
+        worker();
+        for (size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+        if (error)
+            std::rethrow_exception(error);
+
+        size_t total = s.size() + modIndent * prettyIndent + 1;
+        for (size_t c = 0; c < nChunks; c++)
+            total += chunks[c].size();
+        s.reserve(total);
+        for (size_t c = 0; c < nChunks; c++)
+            s += chunks[c];
+    }
+
+    if (prettyIndent)
+        indentStr(prettyIndent, modIndent - 1, s);
+    s += (typ == VOBJ ? "}" : "]");
 
+    return s;
+}
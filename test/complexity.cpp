@@ -0,0 +1,307 @@
+// Copyright 2026 UniValue Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+//
+// Guard against accidentally super-linear code paths.  Each case times
+// one operation on adversarial input of doubling sizes, fits the exponent
+// k of time ~ n^k by least squares on a log-log scale, and fails if k
+// exceeds the case's declared bound by more than a margin for noise.
+//
+// Inputs are wide objects, deep nesting, long runs of escapes, numbers
+// with very many digits and strings of surrogate pairs; operations are
+// read(), write(), key lookup and insertion, and destruction.
+//
+// Timings are taken on whatever else the machine is doing, so this is not
+// one of the "make check" tests; run it with
+//
+// $ make check-complexity
+//
+// or test/complexity [filter] to run only cases whose name contains filter.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "univalue.h"
+
+// Allowed excess over the declared exponent
+static const double EXPONENT_MARGIN = 0.5;
+// Each size is timed for this many rounds of at least MIN_ROUND_SECONDS,
+// and the fastest round kept
+static const int ROUNDS = 3;
+static const double MIN_ROUND_SECONDS = 0.02;
+
+typedef std::chrono::steady_clock timer;
+
+static double since(timer::time_point start)
+{
+    return std::chrono::duration<double>(timer::now() - start).count();
+}
+
+// Seconds per call of run()
+template <typename F>
+static double timePerOp(F run)
+{
+    double best = HUGE_VAL;
+    for (int round = 0; round < ROUNDS; round++) {
+        unsigned long reps = 0;
+        timer::time_point start = timer::now();
+        double elapsed;
+        do {
+            run();
+            reps++;
+            elapsed = since(start);
+        } while (elapsed < MIN_ROUND_SECONDS);
+        best = std::min(best, elapsed / reps);
+    }
+    return best;
+}
+
+// Seconds to destroy one copy of val, timed over batches of copies
+static double timeDestroy(const UniValue& val, size_t n)
+{
+    size_t batch = std::max((size_t)1, ((size_t)1 << 18) / n);
+    double best = HUGE_VAL;
+    for (int round = 0; round < ROUNDS; round++) {
+        std::vector<UniValue> copies(batch, val);
+        timer::time_point start = timer::now();
+        copies.clear();
+        best = std::min(best, since(start) / batch);
+    }
+    return best;
+}
+
+// Least-squares slope of log(secs) against log(sizes)
+static double fitExponent(const std::vector<size_t>& sizes, const std::vector<double>& secs)
+{
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    size_t m = sizes.size();
+    for (size_t i = 0; i < m; i++) {
+        double x = log((double)sizes[i]), y = log(secs[i]);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    return (m * sxy - sx * sy) / (m * sxx - sx * sx);
+}
+
+//
+// Adversarial inputs, n being the number of members, levels or units
+//
+
+static std::string wideObjectText(size_t n)
+{
+    std::string s = "{";
+    for (size_t i = 0; i < n; i++) {
+        if (i)
+            s += ",";
+        s += "\"key" + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    return s + "}";
+}
+
+static UniValue wideObject(size_t n)
+{
+    UniValue obj;
+    obj.read(wideObjectText(n));
+    return obj;
+}
+
+static std::string deepText(size_t n)
+{
+    return std::string(n, '[') + std::string(n, ']');
+}
+
+// Deeper than read() allows, to exercise the recursive paths
+static UniValue deepTree(size_t n)
+{
+    UniValue val(UniValue::VARR);
+    for (size_t i = 1; i < n; i++) {
+        UniValue outer(UniValue::VARR);
+        outer.push_back(std::move(val));
+        val = std::move(outer);
+    }
+    return val;
+}
+
+static std::string repeatString(const char *unit, size_t n)
+{
+    std::string s = "\"";
+    for (size_t i = 0; i < n; i++)
+        s += unit;
+    return s + "\"";
+}
+
+static std::string escapesText(size_t n)
+{
+    return repeatString("\\n\\\"\\u00e9\\t", n);
+}
+
+static std::string surrogatesText(size_t n)
+{
+    return repeatString("\\ud83d\\ude00", n);
+}
+
+static std::string hugeNumberText(size_t n)
+{
+    return "-1." + std::string(n, '7') + "e-" + std::string(n / 4 + 1, '9');
+}
+
+static UniValue parse(const std::string& text)
+{
+    UniValue val;
+    if (!val.read(text)) {
+        fprintf(stderr, "cannot read generated input\n");
+        exit(1);
+    }
+    return val;
+}
+
+//
+// Cases
+//
+
+struct Case {
+    const char *name;
+    double bound;                       // declared exponent
+    size_t firstSize;                   // doubled SIZE_STEPS - 1 times
+    double (*measure)(size_t n);        // seconds for one operation at size n
+};
+
+static const int SIZE_STEPS = 5;
+
+static volatile size_t sink;
+
+static double readText(const std::string& text)
+{
+    UniValue val;
+    return timePerOp([&]() { val.read(text); sink = val.size(); });
+}
+
+static double writeValue(const UniValue& val)
+{
+    return timePerOp([&]() { sink = val.write().size(); });
+}
+
+static double readWide(size_t n) { return readText(wideObjectText(n)); }
+static double readDeep(size_t n) { return readText(deepText(n)); }
+static double readEscapes(size_t n) { return readText(escapesText(n)); }
+static double readSurrogates(size_t n) { return readText(surrogatesText(n)); }
+static double readHugeNumber(size_t n) { return readText(hugeNumberText(n)); }
+
+static double writeWide(size_t n) { return writeValue(wideObject(n)); }
+static double writeDeep(size_t n) { return writeValue(deepTree(n)); }
+static double writeEscapes(size_t n) { return writeValue(parse(escapesText(n))); }
+static double writeSurrogates(size_t n) { return writeValue(parse(surrogatesText(n))); }
+static double writePrettyDeep(size_t n)
+{
+    UniValue val = deepTree(n);
+    return timePerOp([&]() { sink = val.write(1).size(); });
+}
+
+static double findMissingWide(size_t n)
+{
+    UniValue obj = wideObject(n);
+    return timePerOp([&]() { sink = find_value(obj, "absent").isNull(); });
+}
+
+static double findLastWide(size_t n)
+{
+    UniValue obj = wideObject(n);
+    std::string key = "key" + std::to_string(n - 1);
+    return timePerOp([&]() { sink = obj[key].getType(); });
+}
+
+// Each pushKV() looks for an existing key, so building is quadratic
+static double pushKVWide(size_t n)
+{
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; i++)
+        keys.push_back("key" + std::to_string(i));
+    return timePerOp([&]() {
+        UniValue obj(UniValue::VOBJ);
+        for (size_t i = 0; i < n; i++)
+            obj.pushKV(keys[i], (int64_t)i);
+        sink = obj.size();
+    });
+}
+
+static double pushKVsWide(size_t n)
+{
+    UniValue from = wideObject(n);
+    return timePerOp([&]() {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKVs(from);
+        sink = obj.size();
+    });
+}
+
+static double copyDeep(size_t n)
+{
+    UniValue val = deepTree(n);
+    return timePerOp([&]() { UniValue copy(val); sink = copy.size(); });
+}
+
+static double destroyWide(size_t n) { return timeDestroy(wideObject(n), n); }
+static double destroyDeep(size_t n) { return timeDestroy(deepTree(n), n); }
+
+static const Case cases[] = {
+    { "read/wide-object",       1, 4000,  readWide },
+    { "read/deep-nesting",      1, 32,    readDeep },
+    { "read/escape-run",        1, 4000,  readEscapes },
+    { "read/surrogate-pairs",   1, 4000,  readSurrogates },
+    { "read/huge-number",       1, 16000, readHugeNumber },
+    { "write/wide-object",      1, 4000,  writeWide },
+    { "write/deep-nesting",     1, 512,   writeDeep },
+    { "write-pretty/deep-nesting", 2, 256, writePrettyDeep },
+    { "write/escape-run",       1, 4000,  writeEscapes },
+    { "write/surrogate-pairs",  1, 4000,  writeSurrogates },
+    { "find/missing-key",       1, 4000,  findMissingWide },
+    { "find/last-key",          1, 4000,  findLastWide },
+    { "pushKV/wide-object",     2, 1000,  pushKVWide },
+    { "pushKVs/wide-object",    1, 4000,  pushKVsWide },
+    { "copy/deep-nesting",      1, 512,   copyDeep },
+    { "destroy/wide-object",    1, 4000,  destroyWide },
+    { "destroy/deep-nesting",   1, 512,   destroyDeep },
+};
+
+int main(int argc, char *argv[])
+{
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    int failures = 0;
+
+    printf("%-28s %8s %8s  %s\n", "case", "bound", "fitted", "ns at each size");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const Case& tc = cases[c];
+        if (filter && !strstr(tc.name, filter))
+            continue;
+
+        std::vector<size_t> sizes;
+        std::vector<double> secs;
+        for (int step = 0; step < SIZE_STEPS; step++) {
+            sizes.push_back(tc.firstSize << step);
+            secs.push_back(tc.measure(sizes.back()));
+        }
+
+        double k = fitExponent(sizes, secs);
+        bool ok = k <= tc.bound + EXPONENT_MARGIN;
+        printf("%-28s %8.1f %8.2f ", tc.name, tc.bound, k);
+        for (size_t i = 0; i < secs.size(); i++)
+            printf(" %zu:%.0f", sizes[i], secs[i] * 1e9);
+        printf("%s\n", ok ? "" : "  FAIL");
+        fflush(stdout);
+        if (!ok)
+            failures++;
+    }
+
+    if (failures)
+        fprintf(stderr, "%d case(s) grew faster than declared\n", failures);
+    return failures ? 1 : 0;
+}
@@ -10,6 +10,43 @@
 #include <cassert>
 #include <stdexcept>
 #include <univalue.h>
+#include <univalue_batch.h>
+#include <univalue_bind.h>
+#include <univalue_counters.h>
+#include <univalue_cpu.h>
+#include <univalue_jsonpath.h>
+#include <univalue_rcu.h>
+#include <univalue_reader.h>
+#include <univalue_sax.h>
+#include <univalue_schema.h>
+#include <univalue_stream.h>
+#include <univalue_view.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+// Count heap allocations, to check that lookups do not allocate
+static std::atomic<size_t> allocations(0);
+
+static void *countedNew(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t size) { return countedNew(size); }
+void *operator new[](size_t size) { return countedNew(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
 
 #define BOOST_FIXTURE_TEST_SUITE(a, b)
 #define BOOST_AUTO_TEST_CASE(funcName) void funcName()
@@ -398,6 +435,1777 @@ BOOST_AUTO_TEST_CASE(univalue_readwrite)
     BOOST_CHECK(!v.read("{} 42"));
 }
 
+BOOST_AUTO_TEST_CASE(univalue_writeparallel)
+{
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 5000; i++) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("n", i);
+        entry.pushKV("s", "line\n\"" + std::to_string(i));
+        UniValue inner(UniValue::VARR);
+        inner.push_back(i % 2 == 0);
+        inner.push_back(UniValue());
+        entry.pushKV("a", inner);
+        arr.push_back(entry);
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("result", arr);
+    obj.pushKV("id", 1);
+
+    for (unsigned int prettyIndent = 0; prettyIndent < 3; prettyIndent++) {
+        for (unsigned int indentLevel = 0; indentLevel < 3; indentLevel++) {
+            std::string serial = arr.write(prettyIndent, indentLevel);
+            BOOST_CHECK_EQUAL(arr.writeParallel(prettyIndent, indentLevel, 4), serial);
+            BOOST_CHECK_EQUAL(arr.writeParallel(prettyIndent, indentLevel, 3), serial);
+            BOOST_CHECK_EQUAL(obj.writeParallel(prettyIndent, indentLevel, 4),
+                              obj.write(prettyIndent, indentLevel));
+        }
+    }
+
+    BOOST_CHECK_EQUAL(arr.writeParallel(1, 0, 1), arr.write(1, 0));
+    BOOST_CHECK_EQUAL(arr.writeParallel(), arr.write());
+    BOOST_CHECK_EQUAL(UniValue("x").writeParallel(0, 0, 4), "\"x\"");
+    UniValue empty(UniValue::VARR);
+    BOOST_CHECK_EQUAL(empty.writeParallel(2, 0, 4), empty.write(2, 0));
+}
+
+BOOST_AUTO_TEST_CASE(univalue_streamwriter)
+{
+    UniValue sub(UniValue::VOBJ);
+    sub.pushKV("nested", "a\tb");
+    UniValue subArr(UniValue::VARR);
+    subArr.push_back(1);
+    subArr.push_back(UniValue(UniValue::VOBJ));
+    sub.pushKV("arr", subArr);
+
+    UniValue tree(UniValue::VOBJ);
+    tree.pushKV("name", "st\"ream");
+    tree.pushKV("count", (int64_t)-12);
+    tree.pushKV("big", (uint64_t)18446744073709551615ULL);
+    tree.pushKV("real", 1.5);
+    tree.pushKV("flag", true);
+    tree.pushKV("nothing", UniValue());
+    UniValue list(UniValue::VARR);
+    list.push_back(UniValue(UniValue::VARR));
+    list.push_back(sub);
+    list.push_back("x");
+    tree.pushKV("list", list);
+    tree.pushKV("empty", UniValue(UniValue::VOBJ));
+
+    for (unsigned int prettyIndent = 0; prettyIndent < 3; prettyIndent++) {
+        for (unsigned int indentLevel = 0; indentLevel < 3; indentLevel++) {
+            std::string out;
+            UniValueStringSink sink(out);
+            UniValueWriter w(sink, prettyIndent, indentLevel);
+            BOOST_CHECK(w.beginObject());
+            BOOST_CHECK(w.pushKV("name", "st\"ream"));
+            BOOST_CHECK(w.pushKV("count", (int64_t)-12));
+            BOOST_CHECK(w.pushKV("big", (uint64_t)18446744073709551615ULL));
+            BOOST_CHECK(w.pushKV("real", 1.5));
+            BOOST_CHECK(w.pushKV("flag", true));
+            BOOST_CHECK(w.key("nothing") && w.valueNull());
+            BOOST_CHECK(w.key("list"));
+            BOOST_CHECK(w.beginArray());
+            BOOST_CHECK(w.beginArray());
+            BOOST_CHECK(w.endArray());
+            BOOST_CHECK(w.value(sub));
+            BOOST_CHECK(w.value("x"));
+            BOOST_CHECK(w.endArray());
+            BOOST_CHECK(w.key("empty"));
+            BOOST_CHECK(w.beginObject());
+            BOOST_CHECK(w.endObject());
+            BOOST_CHECK_EQUAL(w.depth(), 1);
+            BOOST_CHECK(w.endObject());
+            BOOST_CHECK(w.finish());
+            BOOST_CHECK_EQUAL(out, tree.write(prettyIndent, indentLevel));
+
+            std::string outSub;
+            UniValueStringSink sinkSub(outSub);
+            UniValueWriter wSub(sinkSub, prettyIndent, indentLevel);
+            BOOST_CHECK(wSub.value(tree));
+            BOOST_CHECK(wSub.finish());
+            BOOST_CHECK_EQUAL(outSub, tree.write(prettyIndent, indentLevel));
+        }
+    }
+
+    // well-formedness is enforced
+    std::string out;
+    UniValueStringSink sink(out);
+    UniValueWriter w1(sink);
+    BOOST_CHECK(!w1.key("k"));
+    BOOST_CHECK(w1.failed());
+    BOOST_CHECK(!w1.beginArray());
+
+    UniValueWriter w2(sink);
+    BOOST_CHECK(w2.beginObject());
+    BOOST_CHECK(!w2.value(1));
+
+    UniValueWriter w3(sink);
+    BOOST_CHECK(w3.beginObject());
+    BOOST_CHECK(!w3.endArray());
+
+    UniValueWriter w4(sink);
+    BOOST_CHECK(w4.value(1));
+    BOOST_CHECK(!w4.value(2));
+
+    UniValueWriter w5(sink);
+    BOOST_CHECK(w5.beginArray());
+    BOOST_CHECK(!w5.finish());
+
+    UniValueWriter w6(sink);
+    BOOST_CHECK(w6.beginObject());
+    BOOST_CHECK(w6.key("a"));
+    BOOST_CHECK(!w6.endObject());
+
+    UniValueWriter w7(sink);
+    BOOST_CHECK(!w7.valueNumStr("zombocom"));
+
+    // large streams are flushed incrementally
+    std::string big;
+    UniValueStringSink bigSink(big);
+    UniValueWriter w8(bigSink);
+    UniValue arr(UniValue::VARR);
+    BOOST_CHECK(w8.beginArray());
+    for (int i = 0; i < 20000; i++) {
+        BOOST_CHECK(w8.value(i));
+        arr.push_back(i);
+    }
+    BOOST_CHECK(!big.empty());
+    BOOST_CHECK(w8.endArray());
+    BOOST_CHECK(w8.finish());
+    BOOST_CHECK_EQUAL(big, arr.write());
+}
+
+BOOST_AUTO_TEST_CASE(univalue_cbor)
+{
+    // RFC 8949 Appendix A examples, for the types UniValue can produce
+    BOOST_CHECK_EQUAL(UniValue(0).writeCBOR(), std::string("\x00", 1));
+    BOOST_CHECK_EQUAL(UniValue(23).writeCBOR(), "\x17");
+    BOOST_CHECK_EQUAL(UniValue(24).writeCBOR(), "\x18\x18");
+    BOOST_CHECK_EQUAL(UniValue(1000).writeCBOR(), "\x19\x03\xe8");
+    BOOST_CHECK_EQUAL(UniValue((uint64_t)18446744073709551615ULL).writeCBOR(),
+                      "\x1b\xff\xff\xff\xff\xff\xff\xff\xff");
+    BOOST_CHECK_EQUAL(UniValue(-1).writeCBOR(), " ");
+    BOOST_CHECK_EQUAL(UniValue(-1000).writeCBOR(), "\x39\x03\xe7");
+    BOOST_CHECK_EQUAL(UniValue(1.5).writeCBOR(), std::string("\xfa\x3f\xc0\x00\x00", 5));
+    BOOST_CHECK_EQUAL(UniValue(1.1).writeCBOR(), "\xfb\x3f\xf1\x99\x99\x99\x99\x99\x9a");
+    BOOST_CHECK_EQUAL(UniValue(false).writeCBOR(), "\xf4");
+    BOOST_CHECK_EQUAL(UniValue(true).writeCBOR(), "\xf5");
+    BOOST_CHECK_EQUAL(UniValue().writeCBOR(), "\xf6");
+    BOOST_CHECK_EQUAL(UniValue("IETF").writeCBOR(), "\x64IETF");
+    UniValue arr(UniValue::VARR);
+    arr.push_back(1);
+    arr.push_back(2);
+    BOOST_CHECK_EQUAL(arr.writeCBOR(), "\x82\x01\x02");
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("a", 1);
+    obj.pushKV("b", arr);
+    BOOST_CHECK_EQUAL(obj.writeCBOR(), "\xa2\x61\x61\x01\x61\x62\x82\x01\x02");
+
+    // number text that is neither a 64-bit integer nor a canonical double
+    // survives as tagged text
+    UniValue num;
+    BOOST_CHECK(num.setNumStr("1.10000000"));
+    BOOST_CHECK_EQUAL(num.writeCBOR(), "\xd9\x01\x06\x4a" "1.10000000");
+    const char *numStrs[] = { "1.10000000", "-0", "1e5", "32482348723847471234",
+                              "-9223372036854775808", "-9223372036854775809",
+                              "9223372036854775808", "0.1", "-2.5e-7" };
+    for (size_t i = 0; i < sizeof(numStrs) / sizeof(numStrs[0]); i++) {
+        BOOST_CHECK(num.setNumStr(numStrs[i]));
+        UniValue dec;
+        BOOST_CHECK(dec.readCBOR(num.writeCBOR()));
+        BOOST_CHECK(dec.isNum());
+        BOOST_CHECK_EQUAL(dec.getValStr(), numStrs[i]);
+    }
+
+    // strings that are not UTF-8 are carried as byte strings
+    UniValue bin(std::string("\xff\x00", 2));
+    BOOST_CHECK_EQUAL(bin.writeCBOR(), std::string("\x42\xff\x00", 3));
+    UniValue dec;
+    BOOST_CHECK(dec.readCBOR(bin.writeCBOR()));
+    BOOST_CHECK_EQUAL(dec.get_str(), bin.get_str());
+
+    // and so are keys
+    UniValue binKey(UniValue::VOBJ);
+    binKey.pushKV(std::string("\xff", 1), 1);
+    BOOST_CHECK_EQUAL(binKey.writeCBOR(), std::string("\xa1\x41\xff\x01", 4));
+    BOOST_CHECK(dec.readCBOR(binKey.writeCBOR()));
+    BOOST_CHECK_EQUAL(dec.getKeys()[0], binKey.getKeys()[0]);
+    BOOST_CHECK_EQUAL(dec[0].get_int(), 1);
+
+    // decoder extras: indefinite lengths, half floats, big negatives, tags
+    BOOST_CHECK(dec.readCBOR(std::string("\x9f\x01\x7f\x62xy\x61z\xff\xbf\x61k\xf7\xff\xff", 15)));
+    BOOST_CHECK_EQUAL(dec.write(), "[1,\"xyz\",{\"k\":null}]");
+    BOOST_CHECK(dec.readCBOR(std::string("\xf9\x3e\x00", 3)));
+    BOOST_CHECK_EQUAL(dec.getValStr(), "1.5");
+    BOOST_CHECK(dec.readCBOR("\x3b\xff\xff\xff\xff\xff\xff\xff\xff"));
+    BOOST_CHECK_EQUAL(dec.getValStr(), "-18446744073709551616");
+    BOOST_CHECK(dec.readCBOR("\xc1\x1a\x51\x4b\x67\xb0"));
+    BOOST_CHECK_EQUAL(dec.getValStr(), "1363896240");
+
+    // malformed input
+    BOOST_CHECK(!dec.readCBOR(""));
+    BOOST_CHECK(dec.isNull());
+    BOOST_CHECK(!dec.readCBOR("\x82\x01"));                 // truncated
+    BOOST_CHECK(!dec.readCBOR("\x01\x02"));                 // trailing data
+    BOOST_CHECK(!dec.readCBOR("\xa1\x01\x02"));             // non-string key
+    BOOST_CHECK(!dec.readCBOR("\x62\xc3\x28"));             // bad UTF-8 text
+    BOOST_CHECK(!dec.readCBOR("\xfa\x7f\xc0\x00\x00"));     // NaN
+    BOOST_CHECK(!dec.readCBOR("\x9b\xff\xff\xff\xff\xff\xff\xff\xff"));
+    BOOST_CHECK(!dec.readCBOR("\xd9\x01\x06\x61x"));        // tag 262, not a number
+    std::string deep(1000, '\x81');
+    deep += '\x01';
+    BOOST_CHECK(!dec.readCBOR(deep));
+
+    // number text matches printf's "%.16g" in the C locale, and each double
+    // that formats back to itself travels as a double
+    double doubles[] = { 0.1, 1e-7, 123456789012345678.0, 5e-324, 1.7976931348623157e308,
+                         -0.0, 1e16, 9.999999999999999e15, 0.30000000000000004 };
+    for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.16g", doubles[i]);
+        BOOST_CHECK_EQUAL(UniValue(doubles[i]).getValStr(), buf);
+        BOOST_CHECK(dec.readCBOR(UniValue(doubles[i]).writeCBOR()));
+        BOOST_CHECK_EQUAL(dec.getValStr(), buf);
+    }
+    BOOST_CHECK(num.setNumStr("2.5"));
+    BOOST_CHECK_EQUAL(num.writeCBOR(), std::string("\xfa\x40\x20\x00\x00", 5));
+
+    // streaming into a sink
+    std::string out;
+    UniValueStringSink sink(out);
+    BOOST_CHECK(obj.writeCBOR(sink));
+    BOOST_CHECK_EQUAL(out, obj.writeCBOR());
+}
+
+BOOST_AUTO_TEST_CASE(univalue_msgpack)
+{
+    // smallest encodings
+    BOOST_CHECK_EQUAL(UniValue(0).writeMsgPack(), std::string("\x00", 1));
+    BOOST_CHECK_EQUAL(UniValue(127).writeMsgPack(), "\x7f");
+    BOOST_CHECK_EQUAL(UniValue(128).writeMsgPack(), "\xcc\x80");
+    BOOST_CHECK_EQUAL(UniValue(65535).writeMsgPack(), "\xcd\xff\xff");
+    BOOST_CHECK_EQUAL(UniValue(65536).writeMsgPack(), std::string("\xce\x00\x01\x00\x00", 5));
+    BOOST_CHECK_EQUAL(UniValue((uint64_t)18446744073709551615ULL).writeMsgPack(),
+                      "\xcf\xff\xff\xff\xff\xff\xff\xff\xff");
+    BOOST_CHECK_EQUAL(UniValue(-1).writeMsgPack(), "\xff");
+    BOOST_CHECK_EQUAL(UniValue(-32).writeMsgPack(), "\xe0");
+    BOOST_CHECK_EQUAL(UniValue(-33).writeMsgPack(), "\xd0\xdf");
+    BOOST_CHECK_EQUAL(UniValue(-129).writeMsgPack(), "\xd1\xff\x7f");
+    BOOST_CHECK_EQUAL(UniValue((int64_t)-2147483649LL).writeMsgPack(),
+                      "\xd3\xff\xff\xff\xff\x7f\xff\xff\xff");
+    BOOST_CHECK_EQUAL(UniValue(1.5).writeMsgPack(), std::string("\xca\x3f\xc0\x00\x00", 5));
+    BOOST_CHECK_EQUAL(UniValue(1.1).writeMsgPack(), "\xcb\x3f\xf1\x99\x99\x99\x99\x99\x9a");
+    BOOST_CHECK_EQUAL(UniValue().writeMsgPack(), "\xc0");
+    BOOST_CHECK_EQUAL(UniValue(false).writeMsgPack(), "\xc2");
+    BOOST_CHECK_EQUAL(UniValue(true).writeMsgPack(), "\xc3");
+    BOOST_CHECK_EQUAL(UniValue("abc").writeMsgPack(), "\xa3" "abc");
+    BOOST_CHECK_EQUAL(UniValue(std::string(32, 'x')).writeMsgPack(), "\xd9\x20" + std::string(32, 'x'));
+    BOOST_CHECK_EQUAL(UniValue(std::string(256, 'x')).writeMsgPack().substr(0, 3),
+                      std::string("\xda\x01\x00", 3));
+    BOOST_CHECK_EQUAL(UniValue(std::string("\xff", 1)).writeMsgPack(), "\xc4\x01\xff");
+
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 16; i++)
+        arr.push_back(i);
+    BOOST_CHECK_EQUAL(arr.writeMsgPack().substr(0, 4), std::string("\xdc\x00\x10\x00", 4));
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("z", 1);
+    obj.pushKV("a", UniValue(UniValue::VARR));
+    BOOST_CHECK_EQUAL(obj.writeMsgPack(), "\x82\xa1z\x01\xa1" "a\x90");
+
+    // key order and odd numbers survive a round trip
+    UniValue num;
+    BOOST_CHECK(num.setNumStr("1.10000000"));
+    BOOST_CHECK_EQUAL(num.writeMsgPack(), "\xc7\x0a\x01" "1.10000000");
+    obj.pushKV("num", num);
+    BOOST_CHECK(num.setNumStr("1e10"));
+    BOOST_CHECK_EQUAL(num.writeMsgPack(), "\xd6\x01" "1e10");
+    obj.pushKV("exp", num);
+    BOOST_CHECK(num.setNumStr("-0"));
+    obj.pushKV("negzero", num);
+    UniValue dec;
+    BOOST_CHECK(dec.readMsgPack(obj.writeMsgPack()));
+    BOOST_CHECK_EQUAL(dec.write(), obj.write());
+
+    // streaming into a sink
+    std::string out;
+    UniValueStringSink sink(out);
+    BOOST_CHECK(obj.writeMsgPack(sink));
+    BOOST_CHECK_EQUAL(out, obj.writeMsgPack());
+
+    // decoder accepts non-minimal forms
+    BOOST_CHECK(dec.readMsgPack("\xd1\xff\xfe"));
+    BOOST_CHECK_EQUAL(dec.getValStr(), "-2");
+    BOOST_CHECK(dec.readMsgPack(std::string("\xdf\x00\x00\x00\x01\xc4\x01k\xc0", 9)));
+    BOOST_CHECK_EQUAL(dec.write(), "{\"k\":null}");
+
+    // malformed input
+    BOOST_CHECK(!dec.readMsgPack(""));
+    BOOST_CHECK(!dec.readMsgPack("\x92\x01"));               // truncated
+    BOOST_CHECK(!dec.readMsgPack("\x01\x02"));               // trailing data
+    BOOST_CHECK(!dec.readMsgPack("\x81\x01\x02"));           // non-string key
+    BOOST_CHECK(!dec.readMsgPack("\xa2\xc3\x28"));           // bad UTF-8 str
+    BOOST_CHECK(!dec.readMsgPack("\xc1"));                   // never used
+    BOOST_CHECK(!dec.readMsgPack("\xd4\x02x"));              // unknown ext type
+    BOOST_CHECK(!dec.readMsgPack("\xd4\x01x"));              // ext 1, not a number
+    BOOST_CHECK(!dec.readMsgPack("\xca\x7f\xc0\x00\x00"));   // NaN
+    BOOST_CHECK(!dec.readMsgPack("\xdd\xff\xff\xff\xff"));
+    BOOST_CHECK(dec.isNull());
+    std::string deep(1000, '\x91');
+    deep += '\x01';
+    BOOST_CHECK(!dec.readMsgPack(deep));
+}
+
+BOOST_AUTO_TEST_CASE(univalue_snapshot)
+{
+    UniValue doc;
+    BOOST_CHECK(doc.read("{\"hash\":\"00ab\",\"height\":840000,\"fee\":0.00012345,"
+                         "\"big\":32482348723847471234,\"ok\":true,\"no\":false,\"none\":null,"
+                         "\"tx\":[{\"txid\":\"aa\",\"vout\":[1,2]},{\"txid\":\"b\\u0000c\"}],"
+                         "\"empty\":{},\"list\":[]}"));
+
+    std::string snap;
+    BOOST_CHECK(doc.writeSnapshot(snap));
+    BOOST_CHECK_EQUAL(snap.size() % 4, 0);
+
+    UniValueView root;
+    BOOST_CHECK(UniValueView::open(snap.data(), snap.size(), root));
+    BOOST_CHECK(root.isObject());
+    BOOST_CHECK_EQUAL(root.size(), 10);
+    BOOST_CHECK(root.key(0) == "hash");
+    BOOST_CHECK(root["hash"].get_str() == "00ab");
+    BOOST_CHECK_EQUAL(root["height"].get_int(), 840000);
+    BOOST_CHECK_EQUAL(root["height"].get_int64(), 840000);
+    BOOST_CHECK_EQUAL(root["fee"].get_real(), 0.00012345);
+    BOOST_CHECK(root["fee"].getValStr() == "0.00012345");
+    BOOST_CHECK_THROW(root["big"].get_int64(), std::runtime_error);
+    BOOST_CHECK_THROW(root["hash"].get_int(), std::runtime_error);
+    BOOST_CHECK_THROW(root["height"].get_str(), std::runtime_error);
+    BOOST_CHECK(root["ok"].get_bool());
+    BOOST_CHECK(root["no"].isFalse());
+    BOOST_CHECK(root["none"].isNull());
+    BOOST_CHECK(root["missing"].isNull());
+    BOOST_CHECK(root.exists("none"));
+    BOOST_CHECK(!root.exists("missing"));
+    BOOST_CHECK_EQUAL(root["tx"].size(), 2);
+    BOOST_CHECK_EQUAL(root["tx"][0]["vout"][1].get_int(), 2);
+    BOOST_CHECK(root["tx"][1]["txid"].get_str() == std::string_view("b\0c", 3));
+    BOOST_CHECK(root["tx"][2].isNull());
+    BOOST_CHECK(root["empty"].isObject() && root["empty"].empty());
+    BOOST_CHECK(root["list"].isArray() && root["list"].empty());
+    BOOST_CHECK(root[(size_t)1].isNum());
+
+    UniValue copy;
+    BOOST_CHECK(root.toUniValue(copy));
+    BOOST_CHECK_EQUAL(copy.write(), doc.write());
+    BOOST_CHECK(root["tx"].toUniValue(copy));
+    BOOST_CHECK_EQUAL(copy.write(), doc["tx"].write());
+
+    // scalars at the root
+    BOOST_CHECK(UniValue("bare").writeSnapshot(snap));
+    BOOST_CHECK(UniValueView::open(snap.data(), snap.size(), root));
+    BOOST_CHECK(root.get_str() == "bare");
+
+    // damaged snapshots
+    BOOST_CHECK(doc.writeSnapshot(snap));
+    BOOST_CHECK(!UniValueView::open(snap.data(), snap.size() - 1, root));
+    BOOST_CHECK(!UniValueView::open("UVS", 3, root));
+    std::string bad = snap;
+    bad[0] = 'X';
+    BOOST_CHECK(!UniValueView::open(bad.data(), bad.size(), root));
+    for (size_t i = 16; i < snap.size(); i++) {
+        bad = snap;
+        bad[i] = (char)0xff;
+        if (!UniValueView::open(bad.data(), bad.size(), root))
+            continue;
+        // whatever happens, accesses must stay inside the buffer
+        root["tx"][0]["vout"][1].getValStr();
+        root.toUniValue(copy);
+    }
+
+    // 60 arrays whose two elements both point at the next one: in bounds
+    // and shallow, but 2^60 nodes when copied
+    std::string dag("UVS\x01", 4);
+    dag.append(12, '\0');
+    for (uint32_t k = 0; k < 60; k++) {
+        uint32_t words[3] = { (2 << 3) | UniValue::VARR, 16 + 12 * (k + 1), 16 + 12 * (k + 1) };
+        for (uint32_t w : words)
+            for (int b = 0; b < 4; b++)
+                dag += (char)((w >> (8 * b)) & 0xff);
+    }
+    dag.append(4, '\0');                                   // VNULL
+    dag[4] = (char)dag.size();
+    dag[5] = (char)(dag.size() >> 8);
+    dag[8] = 16;
+    BOOST_CHECK(UniValueView::open(dag.data(), dag.size(), root));
+    BOOST_CHECK(root[(size_t)1][(size_t)0][(size_t)1].isArray());
+    BOOST_CHECK(!root.toUniValue(copy));
+    BOOST_CHECK(copy.isNull());
+
+    // 1000 entries sharing one 10000-byte string: a small snapshot, but
+    // 10MB of text when copied, whether the string is a value or a key
+    auto putLE32 = [](std::string& out, uint32_t w) {
+        for (int b = 0; b < 4; b++)
+            out += (char)((w >> (8 * b)) & 0xff);
+    };
+    for (UniValue::VType type : { UniValue::VARR, UniValue::VOBJ }) {
+        uint32_t entries = 1000, slots = type == UniValue::VOBJ ? 2 : 1;
+        uint32_t strOff = 16 + 4 + 4 * slots * entries;
+        std::string shared("UVS\x01", 4);
+        shared.append(4, '\0');
+        putLE32(shared, 16);
+        shared.append(4, '\0');
+        putLE32(shared, (entries << 3) | type);
+        for (uint32_t i = 0; i < slots * entries; i++)
+            putLE32(shared, strOff);
+        putLE32(shared, (10000 << 3) | UniValue::VSTR);
+        shared.append(10000, 'x');
+        shared.append(4, '\0');                            // NUL, padding
+        std::string total;
+        putLE32(total, shared.size());
+        shared.replace(4, 4, total);
+        BOOST_CHECK(UniValueView::open(shared.data(), shared.size(), root));
+        BOOST_CHECK(root.size() == entries);
+        BOOST_CHECK(!root.toUniValue(copy));
+        BOOST_CHECK(copy.isNull());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(univalue_path)
+{
+    UniValue doc;
+    BOOST_CHECK(doc.read("{\"result\":{\"tx\":[{\"txid\":\"aa\",\"vout\":[{\"value\":1},{\"value\":2}]},"
+                         "{\"txid\":\"bb\",\"vout\":[]}]},\"a/b\":1,\"m~n\":2,\"\":3,\"01\":4}"));
+
+    UniValue::Path p("/result/tx/0/vout/1/value");
+    BOOST_CHECK_EQUAL(p.size(), 6);
+    BOOST_CHECK_EQUAL(p.str(), "/result/tx/0/vout/1/value");
+    BOOST_CHECK_EQUAL(doc.resolve(p).get_int(), 2);
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("/result/tx/1/txid")).get_str(), "bb");
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("")).write(), doc.write());
+
+    // RFC 6901 escaping, empty keys, and keys that look like indices
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("/a~1b")).get_int(), 1);
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("/m~0n")).get_int(), 2);
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("/")).get_int(), 3);
+    BOOST_CHECK_EQUAL(doc.resolve(UniValue::Path("/01")).get_int(), 4);
+
+    // missing members
+    BOOST_CHECK(doc.resolve(UniValue::Path("/result/tx/2")).isNull());
+    BOOST_CHECK(doc.resolve(UniValue::Path("/result/tx/-")).isNull());
+    BOOST_CHECK(doc.resolve(UniValue::Path("/result/tx/01")).isNull());
+    BOOST_CHECK(doc.resolve(UniValue::Path("/result/tx/0/txid/x")).isNull());
+    BOOST_CHECK(doc.resolve(UniValue::Path("/nope")).isNull());
+    BOOST_CHECK(doc.resolve(UniValue::Path("/result/tx/99999999999999999999999")).isNull());
+
+    // malformed pointers
+    UniValue::Path bad;
+    BOOST_CHECK(!bad.parse("result"));
+    BOOST_CHECK(!bad.parse("/a~2"));
+    BOOST_CHECK(!bad.parse("/a~"));
+    BOOST_CHECK_EQUAL(bad.size(), 0);
+    BOOST_CHECK(bad.parse("/a~1~0"));
+    BOOST_CHECK_EQUAL(bad.size(), 1);
+    BOOST_CHECK_THROW(UniValue::Path("x"), std::runtime_error);
+
+    // batch lookups match single lookups
+    const char *pointers[] = { "/result/tx/1/txid", "/result/tx/0/vout/0/value",
+                               "/result/tx/0/txid", "/nope/deeper", "/result/tx/0/vout/1/value",
+                               "/result/tx/0/vout/7", "", "/result/tx/0/vout/1/value" };
+    std::vector<UniValue::Path> paths;
+    for (size_t i = 0; i < sizeof(pointers) / sizeof(pointers[0]); i++)
+        paths.push_back(UniValue::Path(pointers[i]));
+    std::vector<const UniValue*> found;
+    doc.resolve(paths, found);
+    BOOST_CHECK_EQUAL(found.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (found[i])
+            BOOST_CHECK_EQUAL(found[i], &doc.resolve(paths[i]));
+        else
+            BOOST_CHECK(&doc.resolve(paths[i]) == &NullUniValue);
+    }
+    BOOST_CHECK(found[3] == NULL);
+    BOOST_CHECK(found[5] == NULL);
+    BOOST_CHECK_EQUAL(found[6], &doc);
+    BOOST_CHECK_EQUAL(found[1]->get_int(), 1);
+
+    // wide objects with duplicate keys resolve to the first, both ways
+    UniValue wide;
+    BOOST_CHECK(wide.read("{\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,\"k5\":5,"
+                          "\"dup\":{\"x\":1},\"k6\":6,\"k7\":7,\"dup\":{\"x\":2}}"));
+    BOOST_CHECK_EQUAL(wide.resolve(UniValue::Path("/dup/x")).get_int(), 1);
+    BOOST_CHECK_EQUAL(wide.resolve(UniValue::Path("/k7")).get_int(), 7);
+    BOOST_CHECK(wide.resolve(UniValue::Path("/k8")).isNull());
+    paths.assign(1, UniValue::Path("/dup/x"));
+    paths.push_back(UniValue::Path("/dup"));
+    wide.resolve(paths, found);
+    BOOST_CHECK_EQUAL(found[0]->get_int(), 1);
+    BOOST_CHECK_EQUAL(found[1], &wide["dup"]);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_keyviews)
+{
+    UniValue obj(UniValue::VOBJ);
+    BOOST_CHECK(obj.pushKV("a long key that does not fit in SSO", 1));
+    BOOST_CHECK(obj.pushKV(std::string_view("view"), "str value that is long enough"));
+    BOOST_CHECK(obj.pushKV(std::string("str"), 3));
+    UniValue inner(UniValue::VOBJ);
+    inner.pushKV("deep", true);
+    BOOST_CHECK(obj.pushKV("inner", std::move(inner)));
+    BOOST_CHECK(obj.pushKV("str", 4));
+    BOOST_CHECK_EQUAL(obj.size(), 4);
+
+    // key lookups with literals and views do not allocate
+    size_t before = allocations;
+    BOOST_CHECK_EQUAL(obj["a long key that does not fit in SSO"].getValStr(), "1");
+    BOOST_CHECK(obj.exists("view"));
+    BOOST_CHECK(!obj.exists(std::string_view("missing key that is also long")));
+    BOOST_CHECK(find_value(obj, "inner")["deep"].isTrue());
+    BOOST_CHECK(obj["view"].get_str_view() == "str value that is long enough");
+    BOOST_CHECK(obj.key(0) == "a long key that does not fit in SSO");
+    BOOST_CHECK_EQUAL(allocations, before);
+
+    BOOST_CHECK_EQUAL(obj["str"].getValStr(), "4");
+    BOOST_CHECK_THROW(obj["str"].get_str_view(), std::runtime_error);
+    BOOST_CHECK_THROW(obj["str"].key(0), std::runtime_error);
+    BOOST_CHECK_THROW(obj.key(4), std::out_of_range);
+
+    std::map<std::string_view, const UniValue*> kv;
+    obj.getObjMap(kv);
+    BOOST_CHECK_EQUAL(kv.size(), 4);
+    BOOST_CHECK_EQUAL(kv["inner"], &obj["inner"]);
+    BOOST_CHECK(kv["view"]->get_str_view() == "str value that is long enough");
+    BOOST_CHECK(kv.find("missing") == kv.end());
+}
+
+BOOST_AUTO_TEST_CASE(univalue_sax)
+{
+    // records events as a compact trace; skips the member named "skip"
+    class Trace : public UniValueSAXHandler {
+    public:
+        std::string out;
+        Action onNull() override { out += "n"; return SAX_OK; }
+        Action onBool(bool val) override { out += val ? "t" : "f"; return SAX_OK; }
+        Action onNumber(const std::string& text) override { out += "#" + text; return SAX_OK; }
+        Action onString(const std::string& str) override { out += "'" + str; return SAX_OK; }
+        Action onKey(const std::string& key) override {
+            out += "k" + key;
+            return key == "skip" ? SAX_SKIP : (key == "stop" ? SAX_STOP : SAX_OK);
+        }
+        Action onBeginObject() override { out += "{"; return SAX_OK; }
+        Action onEndObject() override { out += "}"; return SAX_OK; }
+        Action onBeginArray() override { out += "["; return SAX_OK; }
+        Action onEndArray() override { out += "]"; return SAX_OK; }
+    };
+
+    Trace t;
+    BOOST_CHECK(readJsonSAX("{\"a\":[1,true,null],\"b\":\"x\"}", t));
+    BOOST_CHECK_EQUAL(t.out, "{ka[#1tn]kb'x}");
+
+    t.out.clear();
+    BOOST_CHECK(readJsonSAX(" 7 ", t));
+    BOOST_CHECK_EQUAL(t.out, "#7");
+
+    // skipped values produce no events, but are still checked
+    t.out.clear();
+    BOOST_CHECK(readJsonSAX("{\"skip\":{\"x\":[1,{\"y\":2}]},\"b\":false}", t));
+    BOOST_CHECK_EQUAL(t.out, "{kskipkbf}");
+    t.out.clear();
+    BOOST_CHECK(readJsonSAX("{\"skip\":3,\"b\":false}", t));
+    BOOST_CHECK_EQUAL(t.out, "{kskipkbf}");
+    BOOST_CHECK(!readJsonSAX("{\"skip\":[1,,2],\"b\":false}", t));
+    BOOST_CHECK(!readJsonSAX("{\"a\":1,\"stop\":2}", t));
+
+    // same grammar as read()
+    const char *bad[] = { "", "[1,]", "{\"a\" 1}", "[1] 2", "{\"a\":1,}", "[}", "01", "{1:2}" };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        UniValue v;
+        BOOST_CHECK(!v.read(bad[i]));
+        BOOST_CHECK(!readJsonSAX(bad[i], t));
+    }
+    std::string deep(513, '[');
+    deep += std::string(513, ']');
+    BOOST_CHECK(!readJsonSAX(deep, t));
+    BOOST_CHECK(readJsonSAX(deep.substr(1, deep.size() - 2), t));
+}
+
+BOOST_AUTO_TEST_CASE(univalue_schema)
+{
+    UniValueSchema input;
+    input.required("txid", UniValue::VSTR).length(64, 64);
+    input.required("vout", UniValue::VNUM).range(0, INT32_MAX);
+
+    UniValueSchema req(UniValueSchema::REJECT_UNKNOWN);
+    req.required("method", UniValue::VSTR).length(1, 16);
+    req.optional("id", UniValue::VNUM);
+    req.optional("verbose", UniValue::VBOOL);
+    req.required("inputs", UniValue::VARR).nested(input);
+
+    std::string txid(64, 'a');
+    std::string good = "{\"method\":\"send\",\"inputs\":[{\"txid\":\"" + txid +
+                       "\",\"vout\":1,\"extra\":[1,2]}],\"id\":5}";
+    UniValue v;
+    BOOST_CHECK(v.read(good));
+    std::vector<std::string> errors;
+    BOOST_CHECK(req.validate(v, errors));
+    BOOST_CHECK(errors.empty());
+    BOOST_CHECK(req.validateJSON(good, errors));
+    BOOST_CHECK(errors.empty());
+
+    // every violation is reported, in the same order by both paths
+    std::string bad = "{\"method\":\"\",\"verbose\":1,\"bogus\":{},\"inputs\":"
+                      "[{\"txid\":\"ab\",\"vout\":-1},7,{\"vout\":1.5}],\"id\":1,\"id\":2}";
+    const char *expected[] = {
+        "String length out of range for method",
+        "Expected type bool for verbose, got number",
+        "Unexpected key bogus",
+        "String length out of range for inputs[0].txid",
+        "Value out of range for inputs[0].vout",
+        "Expected type object for inputs[1], got number",
+        "Expected integer for inputs[2].vout",
+        "Missing inputs[2].txid",
+        "Duplicate key id",
+    };
+    size_t nExpected = sizeof(expected) / sizeof(expected[0]);
+    BOOST_CHECK(v.read(bad));
+    BOOST_CHECK(!req.validate(v, errors));
+    BOOST_CHECK_EQUAL(errors.size(), nExpected);
+    for (size_t i = 0; i < nExpected && i < errors.size(); i++)
+        BOOST_CHECK_EQUAL(errors[i], expected[i]);
+    BOOST_CHECK(!req.validateJSON(bad, errors));
+    BOOST_CHECK_EQUAL(errors.size(), nExpected);
+    for (size_t i = 0; i < nExpected && i < errors.size(); i++)
+        BOOST_CHECK_EQUAL(errors[i], expected[i]);
+
+    BOOST_CHECK(!req.validate(UniValue(UniValue::VOBJ), errors));
+    BOOST_CHECK_EQUAL(errors.size(), 2U);
+    BOOST_CHECK_EQUAL(errors[0], "Missing method");
+    BOOST_CHECK(!req.validate(UniValue(UniValue::VARR), errors));
+    BOOST_CHECK_EQUAL(errors[0], "Expected type object, got array");
+    BOOST_CHECK(!req.validateJSON("[1]", errors));
+    BOOST_CHECK_EQUAL(errors[0], "Expected type object, got array");
+    BOOST_CHECK(!req.validateJSON("{\"method\":", errors));
+    BOOST_CHECK_EQUAL(errors.size(), 1U);
+    BOOST_CHECK_EQUAL(errors[0], "Parse error");
+
+    // unknown members are allowed by default; re-adding a key replaces it
+    UniValueSchema loose;
+    loose.required("a", UniValue::VSTR);
+    loose.required("a", UniValue::VNUM);
+    BOOST_CHECK(loose.validateJSON("{\"x\":[{}],\"a\":3}", errors));
+    BOOST_CHECK(loose.validate(UniValue(UniValue::VOBJ)) == false);
+}
+
+struct BoundInput {
+    std::string txid;
+    int vout;
+    std::optional<bool> spent;
+};
+
+template<> struct UniValueFields<BoundInput> {
+    static constexpr auto fields = std::make_tuple(
+        UniValueField("txid", &BoundInput::txid),
+        UniValueField("vout", &BoundInput::vout),
+        UniValueField("spent", &BoundInput::spent));
+};
+
+struct BoundTx {
+    int version;
+    std::vector<BoundInput> inputs;
+    double fee;
+    std::optional<int64_t> time;
+    std::optional<std::string> comment;
+};
+
+template<> struct UniValueFields<BoundTx> {
+    static constexpr auto fields = std::make_tuple(
+        UniValueField("version", &BoundTx::version),
+        UniValueField("inputs", &BoundTx::inputs),
+        UniValueField("fee", &BoundTx::fee),
+        UniValueField("time", &BoundTx::time),
+        UniValueField("comment", &BoundTx::comment));
+};
+
+BOOST_AUTO_TEST_CASE(univalue_bind)
+{
+    std::string txid(64, 'a');
+    std::string json = "{\"version\":2,\"inputs\":[{\"txid\":\"" + txid + "\",\"vout\":1,"
+                       "\"script\":{\"asm\":[1,[2]],\"hex\":\"00\"}},"
+                       "{\"txid\":\"b\",\"vout\":0,\"spent\":true}],"
+                       "\"fee\":0.0001,\"time\":1700000000000,\"comment\":null,"
+                       "\"vout\":3,\"version\":7}";
+    BoundTx tx;
+    decodeJSON(json, tx);
+    BOOST_CHECK_EQUAL(tx.version, 2);               // first duplicate wins
+    BOOST_CHECK_EQUAL(tx.inputs.size(), 2U);
+    BOOST_CHECK_EQUAL(tx.inputs[0].txid, txid);
+    BOOST_CHECK_EQUAL(tx.inputs[0].vout, 1);
+    BOOST_CHECK(!tx.inputs[0].spent);
+    BOOST_CHECK_EQUAL(tx.inputs[1].txid, "b");
+    BOOST_CHECK(tx.inputs[1].spent && *tx.inputs[1].spent);
+    BOOST_CHECK_EQUAL(tx.fee, 0.0001);
+    BOOST_CHECK_EQUAL(tx.time, 1700000000000LL);
+    BOOST_CHECK(!tx.comment);
+
+    // the same result as walking a UniValue with the strict getters
+    UniValue v;
+    BOOST_CHECK(v.read(json));
+    BOOST_CHECK_EQUAL(tx.version, v["version"].get_int());
+    BOOST_CHECK_EQUAL(tx.fee, v["fee"].get_real());
+    BOOST_CHECK_EQUAL(tx.time, v["time"].get_int64());
+
+    // errors carry the strict getters' messages
+    const char *bad[][2] = {
+        { "[]", "JSON value is not an object as expected" },
+        { "{\"version\":\"2\"}", "JSON value is not an integer as expected" },
+        { "{\"version\":1.5}", "JSON integer out of range" },
+        { "{\"version\":2147483648}", "JSON integer out of range" },
+        { "{\"version\":1,\"inputs\":{}}", "JSON value is not an array as expected" },
+        { "{\"version\":1,\"inputs\":[{\"txid\":1}]}", "JSON value is not a string as expected" },
+        { "{\"version\":1,\"inputs\":[{\"txid\":\"a\",\"vout\":0,\"spent\":0}]}",
+          "JSON value is not a boolean as expected" },
+        { "{\"version\":1,\"inputs\":[{\"txid\":\"a\"}]}", "JSON value is not an integer as expected" },
+        { "{\"version\":1,\"inputs\":[],\"fee\":\"x\"}", "JSON value is not a number as expected" },
+        { "{\"version\":1,\"inputs\":[],\"fee\":1e999}", "JSON double out of range" },
+        { "{\"version\":1,\"inputs\":[]}", "JSON value is not a number as expected" },
+        { "{\"version\":1,", "JSON parse error" },
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        BoundTx t;
+        try {
+            decodeJSON(bad[i][0], strlen(bad[i][0]), t);
+            BOOST_CHECK(false);
+        } catch (const std::runtime_error& e) {
+            BOOST_CHECK_EQUAL(std::string(e.what()), bad[i][1]);
+        }
+    }
+
+    // scalars and containers decode at the top level too
+    std::vector<std::optional<int64_t>> nums;
+    decodeJSON("[1,null,-3]", nums);
+    BOOST_CHECK_EQUAL(nums.size(), 3U);
+    BOOST_CHECK(*nums[0] == 1 && !nums[1] && *nums[2] == -3);
+    std::string str;
+    decodeJSON("\"\\u00e9\"", str);
+    BOOST_CHECK_EQUAL(str, "\xc3\xa9");
+    BOOST_CHECK_THROW(decodeJSON("7", str), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_encode)
+{
+    BoundTx tx;
+    tx.version = 2;
+    tx.fee = 0.0001;
+    tx.time = -1700000000000LL;
+    tx.comment = "tab\there \"quoted\" \xc3\xa9";
+    for (int i = 0; i < 3; i++) {
+        BoundInput in;
+        in.txid = std::string(64, 'a' + i);
+        in.vout = i;
+        if (i == 1)
+            in.spent = false;
+        tx.inputs.push_back(in);
+    }
+
+    // the same document built with pushKV
+    UniValue inputs(UniValue::VARR);
+    for (size_t i = 0; i < tx.inputs.size(); i++) {
+        UniValue in(UniValue::VOBJ);
+        in.pushKV("txid", tx.inputs[i].txid);
+        in.pushKV("vout", tx.inputs[i].vout);
+        if (tx.inputs[i].spent)
+            in.pushKV("spent", *tx.inputs[i].spent);
+        inputs.push_back(in);
+    }
+    UniValue v(UniValue::VOBJ);
+    v.pushKV("version", tx.version);
+    v.pushKV("inputs", inputs);
+    v.pushKV("fee", tx.fee);
+    v.pushKV("time", *tx.time);
+    v.pushKV("comment", *tx.comment);
+
+    BOOST_CHECK_EQUAL(encodeJSON(tx), v.write());
+    BOOST_CHECK_EQUAL(encodeJSON(tx, 4), v.write(4));
+
+    // round trip, and empty optionals are left out
+    BoundTx back;
+    decodeJSON(encodeJSON(tx), back);
+    BOOST_CHECK_EQUAL(encodeJSON(back), encodeJSON(tx));
+    tx.time.reset();
+    tx.comment.reset();
+    BOOST_CHECK(encodeJSON(tx).find("time") == std::string::npos);
+    BOOST_CHECK(encodeJSON(tx).find("comment") == std::string::npos);
+
+    // fewer allocations than building the tree
+    size_t before = allocations;
+    std::string direct = encodeJSON(tx);
+    size_t directAllocs = allocations - before;
+    before = allocations;
+    UniValue tree(UniValue::VOBJ);
+    tree.pushKV("version", tx.version);
+    tree.pushKV("inputs", inputs);
+    tree.pushKV("fee", tx.fee);
+    std::string viaTree = tree.write();
+    BOOST_CHECK(allocations - before > directAllocs);
+
+    // inside a larger stream, and at the top level
+    std::string out;
+    UniValueStringSink sink(out);
+    UniValueWriter w(sink);
+    BOOST_CHECK(w.beginArray() && encodeJSON(w, tx.inputs[0]) && encodeJSON(w, 7) && w.endArray());
+    BOOST_CHECK(w.finish());
+    BOOST_CHECK_EQUAL(out, "[{\"txid\":\"" + tx.inputs[0].txid + "\",\"vout\":0},7]");
+
+    std::vector<std::optional<double>> nums = { 1.5, std::nullopt };
+    BOOST_CHECK_EQUAL(encodeJSON(nums), "[1.5,null]");
+    BOOST_CHECK_THROW(encodeJSON(std::vector<double>(1, NAN)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_jsonpath)
+{
+    std::string json =
+        "{\"result\":{\"height\":5,\"tx\":["
+        "{\"txid\":\"a\",\"vout\":["
+            "{\"value\":0.5,\"scriptPubKey\":{\"address\":\"addr1\"}},"
+            "{\"value\":2,\"scriptPubKey\":{\"address\":\"addr2\"}}]},"
+        "{\"txid\":\"b\",\"vout\":["
+            "{\"value\":1.5,\"scriptPubKey\":{\"address\":\"addr3\"}},"
+            "{\"value\":1,\"scriptPubKey\":{\"hex\":\"00\"}},"
+            "{\"value\":7,\"scriptPubKey\":{}}]}]},"
+        "\"error\":null,\"id\":\"x/y~z\"}";
+    UniValue doc;
+    BOOST_CHECK(doc.read(json));
+
+    // every query gives the same results from the tree and from the text
+    struct { const char *path; const char *expected; } cases[] = {
+        { "$.result.tx[*].vout[?(@.value > 1)].scriptPubKey.address", "[\"addr2\",\"addr3\"]" },
+        { "$.result.tx[1].txid", "[\"b\"]" },
+        { "$['result'][\"tx\"][0].vout[1].value", "[2]" },
+        { "$.result.tx[2]", "[]" },
+        { "$.result.height.x", "[]" },
+        { "$..address", "[\"addr1\",\"addr2\",\"addr3\"]" },
+        { "$..vout[?(@.scriptPubKey.hex)].value", "[1]" },
+        { "$..vout[?(@.scriptPubKey.hex == '00')].value", "[1]" },
+        { "$..[?(@.txid != 'a')].txid", "[\"b\"]" },
+        { "$.result.tx[*].vout[?(@.value <= 1)].value", "[0.5,1]" },
+        { "$.result.tx[*].vout[?(@.value >= 7)].value", "[7]" },
+        { "$.result.tx[*].vout[?(@.value == '2')].value", "[]" },
+        { "$.result.tx[*].vout[?(@.value < 'z')].value", "[]" },
+        { "$.result.tx[0].vout[*].value", "[0.5,2]" },
+        { "$.result.*", "[5,[{\"txid\":\"a\",\"vout\":[{\"value\":0.5,\"scriptPubKey\":{\"address\":\"addr1\"}},"
+                        "{\"value\":2,\"scriptPubKey\":{\"address\":\"addr2\"}}]},{\"txid\":\"b\",\"vout\":["
+                        "{\"value\":1.5,\"scriptPubKey\":{\"address\":\"addr3\"}},{\"value\":1,\"scriptPubKey\":"
+                        "{\"hex\":\"00\"}},{\"value\":7,\"scriptPubKey\":{}}]}]]" },
+        { "$[?(@ == null)]", "[null]" },
+        { "$[?(@ > 'x')]", "[\"x/y~z\"]" },
+        { "$..[?(@.address)].address", "[\"addr1\",\"addr2\",\"addr3\"]" },
+        { "$.result.tx[0].vout[0]..*", "[0.5,{\"address\":\"addr1\"},\"addr1\"]" },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        UniValueJSONPath path(cases[i].path);
+        std::vector<const UniValue*> fromTree;
+        path.select(doc, fromTree);
+        UniValue treeResults(UniValue::VARR);
+        for (size_t j = 0; j < fromTree.size(); j++)
+            treeResults.push_back(*fromTree[j]);
+        BOOST_CHECK_EQUAL(treeResults.write(), cases[i].expected);
+
+        std::vector<UniValue> fromText;
+        BOOST_CHECK(path.selectJSON(json, fromText));
+        UniValue textResults(UniValue::VARR);
+        for (size_t j = 0; j < fromText.size(); j++)
+            textResults.push_back(fromText[j]);
+        BOOST_CHECK_EQUAL(textResults.write(), cases[i].expected);
+    }
+
+    // the whole document, and scalar documents
+    std::vector<UniValue> results;
+    BOOST_CHECK(UniValueJSONPath("$").selectJSON(json, results));
+    BOOST_CHECK_EQUAL(results.size(), 1U);
+    BOOST_CHECK_EQUAL(results[0].write(), doc.write());
+    BOOST_CHECK(UniValueJSONPath("$").selectJSON("3", results));
+    BOOST_CHECK_EQUAL(results[0].getValStr(), "3");
+    BOOST_CHECK(UniValueJSONPath("$.a").selectJSON("3", results));
+    BOOST_CHECK(results.empty());
+
+    // skipped input must still be valid JSON
+    BOOST_CHECK(!UniValueJSONPath("$.a").selectJSON("{\"b\":[1,],\"a\":1}", results));
+    BOOST_CHECK(results.empty());
+
+    const char *invalid[] = {
+        "", "result", "$.", "$..", "$[", "$[01]", "$[-1]", "$['a]", "$[?(@.a ~ 1)]",
+        "$[?(@.a == )]", "$[?(@.a == 1x)]", "$[?(a)]", "$.a b", "$[*",
+    };
+    UniValueJSONPath path;
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+        BOOST_CHECK(!path.parse(invalid[i]));
+    BOOST_CHECK_THROW(UniValueJSONPath("$["), std::runtime_error);
+    std::string deep = "$";
+    for (int i = 0; i < 64; i++)
+        deep += ".a";
+    BOOST_CHECK(!path.parse(deep));
+    BOOST_CHECK(path.parse(deep.substr(0, deep.size() - 2)));
+}
+
+BOOST_AUTO_TEST_CASE(univalue_freeze)
+{
+    UniValue v(UniValue::VOBJ);
+    v.pushKV("name", "config");
+    v.pushKV("list", UniValue(UniValue::VARR));
+
+    std::shared_ptr<const UniValue> copied = v.freeze();
+    BOOST_CHECK_EQUAL(copied->write(), v.write());
+    std::shared_ptr<const UniValue> moved = std::move(v).freeze();
+    BOOST_CHECK_EQUAL(moved->write(), copied->write());
+    std::shared_ptr<const UniValue> shared = moved;
+    BOOST_CHECK_EQUAL(moved.use_count(), 2);
+
+    UniValueRCU slot;
+    BOOST_CHECK(slot.load()->isNull());
+    slot.store(moved);
+    BOOST_CHECK(slot.load() == moved);
+    slot.store(std::shared_ptr<const UniValue>());
+    BOOST_CHECK(slot.load()->isNull());
+
+    // readers keep whatever snapshot they loaded while a writer publishes
+    // new ones; each snapshot they see is internally consistent
+    UniValue start(UniValue::VOBJ);
+    start.pushKV("a", 0);
+    start.pushKV("b", 0);
+    slot.store(std::move(start));
+    std::shared_ptr<const UniValue> first = slot.load();
+
+    const int updates = 200;
+    std::atomic<bool> bad(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&slot, &bad]() {
+            int64_t last = 0;
+            while (last < updates) {
+                std::shared_ptr<const UniValue> snap = slot.load();
+                int64_t a = (*snap)["a"].get_int64();
+                if (a != (*snap)["b"].get_int64() || a < last)
+                    bad = true;
+                last = a;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; t++) {
+        writers.emplace_back([&slot]() {
+            for (int i = 0; i < updates / 2; i++) {
+                slot.update([](UniValue& val) {
+                    int64_t n = val["a"].get_int64() + 1;
+                    val.pushKV("a", n);
+                    val.pushKV("b", n);
+                });
+            }
+        });
+    }
+    for (size_t t = 0; t < writers.size(); t++)
+        writers[t].join();
+    for (size_t t = 0; t < readers.size(); t++)
+        readers[t].join();
+
+    BOOST_CHECK(!bad);
+    BOOST_CHECK_EQUAL((*slot.load())["a"].get_int64(), updates);
+    BOOST_CHECK_EQUAL((*first)["a"].get_int64(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_batch)
+{
+    // echo the params back; requests without an id are notifications,
+    // and the slowest request comes first
+    std::atomic<int> calls(0);
+    UniValueBatchHandler echo = [&calls](const UniValue& req, UniValue& reply) {
+        calls++;
+        if (req["method"].get_str() == "slow")
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (!req.exists("id"))
+            return false;
+        reply.setObject();
+        reply.pushKV("result", req["params"]);
+        reply.pushKV("id", req["id"]);
+        return true;
+    };
+
+    std::string batch = " [{\"method\":\"slow\",\"params\":[\"],[{\"],\"id\":0},";
+    UniValue expected(UniValue::VARR);
+    for (int i = 1; i < 50; i++) {
+        UniValue req(UniValue::VOBJ);
+        req.pushKV("method", "fast");
+        req.pushKV("params", UniValue(UniValue::VARR));
+        if (i % 7) {
+            req.pushKV("id", i);
+            UniValue reply(UniValue::VOBJ);
+            reply.pushKV("result", UniValue(UniValue::VARR));
+            reply.pushKV("id", i);
+            expected.push_back(reply);
+        }
+        batch += (i > 1 ? ",\n" : "") + req.write();
+    }
+    batch += "] ";
+
+    for (unsigned int nThreads = 1; nThreads <= 4; nThreads++) {
+        calls = 0;
+        std::string out;
+        UniValueStringSink sink(out);
+        UniValueWriter w(sink);
+        BOOST_CHECK(processJsonBatch(batch, echo, w, nThreads));
+        BOOST_CHECK(w.finish());
+        BOOST_CHECK_EQUAL(calls, 50);
+
+        UniValue replies;
+        BOOST_CHECK(replies.read(out));
+        BOOST_CHECK_EQUAL(replies.size(), expected.size() + 1);
+        BOOST_CHECK_EQUAL(replies[0]["result"][0].get_str(), "],[{");
+        for (size_t i = 0; i < expected.size(); i++)
+            BOOST_CHECK_EQUAL(replies[i + 1].write(), expected[i].write());
+    }
+
+    // all notifications: nothing is written
+    {
+        std::string out;
+        UniValueStringSink sink(out);
+        UniValueWriter w(sink);
+        BOOST_CHECK(processJsonBatch("[{\"method\":\"a\"},{\"method\":\"b\"}]", echo, w));
+        w.flush();
+        BOOST_CHECK(out.empty());
+    }
+
+    // an empty batch: one Invalid Request error, without calling the handler
+    {
+        calls = 0;
+        std::string out;
+        UniValueStringSink sink(out);
+        UniValueWriter w(sink);
+        BOOST_CHECK(processJsonBatch(" [ ] ", echo, w));
+        BOOST_CHECK(w.finish());
+        BOOST_CHECK_EQUAL(calls, 0);
+        BOOST_CHECK_EQUAL(out, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,"
+                               "\"message\":\"Invalid Request\"},\"id\":null}");
+    }
+
+    // handlers may process batches of their own while the pool is busy
+    {
+        UniValueBatchHandler nested = [&echo](const UniValue& req, UniValue& reply) {
+            if (!req.exists("id"))
+                return false;
+            std::string inner;
+            UniValueStringSink innerSink(inner);
+            UniValueWriter innerOut(innerSink);
+            UniValue innerBatch(UniValue::VARR);
+            innerBatch.push_back(req);
+            innerBatch.push_back(req);
+            if (!processJsonBatch(innerBatch.write(), echo, innerOut, 4) || !innerOut.finish())
+                throw std::runtime_error("inner batch failed");
+            return reply.read(inner);
+        };
+        std::string out;
+        UniValueStringSink sink(out);
+        UniValueWriter w(sink);
+        BOOST_CHECK(processJsonBatch(batch, nested, w, 4));
+        BOOST_CHECK(w.finish());
+        UniValue replies;
+        BOOST_CHECK(replies.read(out));
+        BOOST_CHECK_EQUAL(replies.size(), expected.size() + 1);
+        BOOST_CHECK_EQUAL(replies[1].size(), 2);
+        BOOST_CHECK_EQUAL(replies[1][1].write(), expected[0].write());
+    }
+
+    // a malformed batch calls no handlers
+    const char *bad[] = {
+        "", "{}", "[", "[1,]", "[,1]", "[1,,2]", "[1] x", "[{]}", "[\"a]",
+        "[{\"method\":\"a\",\"id\":1},{\"method\":}]", "[[}]",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        calls = 0;
+        std::string out;
+        UniValueStringSink sink(out);
+        UniValueWriter w(sink);
+        BOOST_CHECK(!processJsonBatch(bad[i], strlen(bad[i]), echo, w, 2));
+        BOOST_CHECK_EQUAL(calls, 0);
+    }
+
+    // handler exceptions reach the caller
+    std::string out;
+    UniValueStringSink sink(out);
+    UniValueWriter w(sink);
+    BOOST_CHECK_THROW(processJsonBatch("[{\"id\":1},{\"id\":2}]", echo, w, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_reader)
+{
+    std::string json = "{\"jsonrpc\":\"2.0\",\"method\":\"getblockheader\",\"params\":"
+                       "[\"0000000000000000000a1b2c3d4e5f60718293a4b5c6d7e8f9\",true,[1.5,null]],"
+                       "\"id\":12345}";
+    UniValue expected;
+    BOOST_CHECK(expected.read(json));
+
+    UniValueReader reader;
+    UniValue v;
+    for (int i = 0; i < 3; i++) {
+        BOOST_CHECK(reader.read(json, v));
+        BOOST_CHECK_EQUAL(v.write(), expected.write());
+    }
+
+    // steady state: parsing the same shape again allocates nothing
+    size_t before = allocations;
+    for (int i = 0; i < 100; i++)
+        BOOST_CHECK(reader.read(json, v));
+    BOOST_CHECK_EQUAL(allocations - before, 0U);
+    BOOST_CHECK_EQUAL(v.write(), expected.write());
+
+    // different documents, failures and scalars give the same results as read()
+    const char *docs[] = {
+        "[1,{\"a\":[true,false]},\"x\"]", "  \"str\" ", "-0.5e3", "null", "[]", "{}",
+        "[1,2", "{\"a\":1}}", "", "[\"\\u00e9\\ud83d\\ude00\"]", "{\"a\":1,\"a\":2}",
+    };
+    for (size_t i = 0; i < sizeof(docs) / sizeof(docs[0]); i++) {
+        UniValue ref;
+        bool ok = ref.read(docs[i]);
+        BOOST_CHECK_EQUAL(reader.read(docs[i], strlen(docs[i]), v), ok);
+        BOOST_CHECK_EQUAL(v.write(), ref.write());
+        BOOST_CHECK_EQUAL(v.getType(), ref.getType());
+        BOOST_CHECK_EQUAL(v.size(), ref.size());
+    }
+
+    // recycled nodes are handed back out
+    BOOST_CHECK(reader.read(json, v));
+    size_t pooled = reader.pooled();
+    reader.recycle(v);
+    BOOST_CHECK(v.isNull());
+    BOOST_CHECK_EQUAL(reader.pooled(), pooled + 9);
+    BOOST_CHECK(reader.read(json, v));
+    BOOST_CHECK_EQUAL(reader.pooled(), pooled);
+    reader.release();
+    BOOST_CHECK_EQUAL(reader.pooled(), 0U);
+    BOOST_CHECK(reader.read(json, v));
+    BOOST_CHECK_EQUAL(v.write(), expected.write());
+}
+
+BOOST_AUTO_TEST_CASE(univalue_memusage)
+{
+    // glibc-style malloc rounding, as used by dynamicMemoryUsage()
+    auto mallocUsage = [](size_t n) -> size_t {
+        return sizeof(void *) == 8 ? ((n + 31) >> 4) << 4 : ((n + 15) >> 3) << 3;
+    };
+
+    UniValue v;
+    BOOST_CHECK_EQUAL(v.dynamicMemoryUsage(), 0U);
+    BOOST_CHECK(v.setStr("short"));
+    BOOST_CHECK_EQUAL(v.dynamicMemoryUsage(), 0U);
+    std::string longStr(100, 'x');
+    BOOST_CHECK(v.setStr(longStr));
+    BOOST_CHECK_EQUAL(v.dynamicMemoryUsage(), mallocUsage(v.getValStr().capacity() + 1));
+    BOOST_CHECK_EQUAL(UniValue(longStr).dynamicMemoryUsage(), v.dynamicMemoryUsage());
+
+    UniValue arr(UniValue::VARR);
+    arr.reserve(3);
+    for (int i = 0; i < 3; i++)
+        BOOST_CHECK(arr.push_back(i));
+    BOOST_CHECK_EQUAL(arr.dynamicMemoryUsage(), mallocUsage(3 * sizeof(UniValue)));
+    BOOST_CHECK(arr.push_back(v));
+    size_t arrUsage = arr.dynamicMemoryUsage();
+    BOOST_CHECK(arrUsage > mallocUsage(4 * sizeof(UniValue)) + v.dynamicMemoryUsage() - 1);
+
+    // usage propagates up through nested pushes, and comes back out when
+    // a member is replaced
+    UniValue obj(UniValue::VOBJ);
+    BOOST_CHECK(obj.pushKV("a", arr));
+    size_t objUsage = obj.dynamicMemoryUsage();
+    BOOST_CHECK(objUsage > UniValue(arr).dynamicMemoryUsage());
+    BOOST_CHECK(obj.pushKV("a", 1));
+    BOOST_CHECK(obj.dynamicMemoryUsage() < objUsage);
+    BOOST_CHECK_EQUAL(obj.dynamicMemoryUsage(), mallocUsage(sizeof(std::string)) +
+                      mallocUsage(sizeof(UniValue)));
+    BOOST_CHECK(obj.pushKV(longStr, arr));
+    BOOST_CHECK_EQUAL(obj.dynamicMemoryUsage(), mallocUsage(2 * sizeof(std::string)) +
+                      mallocUsage(2 * sizeof(UniValue)) + mallocUsage(longStr.size() + 1) +
+                      UniValue(arr).dynamicMemoryUsage());
+
+    // moving hands the count over; a copy is counted afresh
+    UniValue moved(std::move(obj));
+    BOOST_CHECK_EQUAL(obj.dynamicMemoryUsage(), 0U);
+    BOOST_CHECK(moved.dynamicMemoryUsage() > 0);
+    UniValue copy = moved;
+    UniValue copy2 = copy;
+    BOOST_CHECK_EQUAL(copy.dynamicMemoryUsage(), copy2.dynamicMemoryUsage());
+    obj = std::move(copy);
+    BOOST_CHECK_EQUAL(obj.dynamicMemoryUsage(), copy2.dynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(copy.dynamicMemoryUsage(), 0U);
+    // clear() drops the children but keeps the arrays' capacity
+    obj.clear();
+    BOOST_CHECK_EQUAL(obj.dynamicMemoryUsage(), mallocUsage(2 * sizeof(std::string)) +
+                      mallocUsage(2 * sizeof(UniValue)));
+
+    // parsed trees agree with a recount, however they were read
+    std::string json = "{\"result\":{\"hash\":\"" + std::string(64, 'a') + "\",\"tx\":["
+                       "{\"txid\":\"" + std::string(64, 'b') + "\",\"vout\":[1,2.5,null]},"
+                       "{\"txid\":\"" + std::string(64, 'c') + "\",\"vout\":[]}]},\"id\":7}";
+    UniValue parsed;
+    BOOST_CHECK(parsed.read(json));
+    UniValueReader reader;
+    UniValue reused;
+    for (int i = 0; i < 3; i++) {
+        BOOST_CHECK(reader.read(json, reused));
+        BOOST_CHECK(reused.dynamicMemoryUsage() >= parsed.dynamicMemoryUsage());
+    }
+
+    // the callback sees the running total grow up to the final figure
+    std::vector<size_t> reports;
+    reader.setUsageCallback([&reports](size_t usage) {
+        reports.push_back(usage);
+        return true;
+    });
+    reader.recycle(reused);
+    reader.release();
+    BOOST_CHECK(reader.read(json, reused));
+    BOOST_CHECK(reports.size() > 5);
+    for (size_t i = 1; i < reports.size(); i++)
+        BOOST_CHECK(reports[i] > reports[i - 1]);
+    BOOST_CHECK_EQUAL(reports.back(), reused.dynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(reused.dynamicMemoryUsage(), parsed.dynamicMemoryUsage());
+
+    // and can refuse a document that goes over budget
+    size_t budget = parsed.dynamicMemoryUsage() / 2;
+    reader.setUsageCallback([budget](size_t usage) { return usage <= budget; });
+    BOOST_CHECK(!reader.read(json, reused));
+    BOOST_CHECK(reused.isNull());
+    reader.setUsageCallback(UniValueUsageCallback());
+    BOOST_CHECK(reader.read(json, reused));
+    BOOST_CHECK_EQUAL(reused.write(), parsed.write());
+}
+
+BOOST_AUTO_TEST_CASE(univalue_read_limits)
+{
+    UniValueReader reader;
+    UniValue v;
+    std::string json = "{\"method\":\"sendrawtransaction\",\"params\":[\"" +
+                       std::string(200, 'f') + "\",[1,2,3]],\"id\":1}";
+    BOOST_CHECK(reader.read(json, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_OK);
+    UniValue expected;
+    BOOST_CHECK(expected.read(json));
+    BOOST_CHECK(!reader.read("[1,", 3, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_SYNTAX);
+    BOOST_CHECK_EQUAL(std::string(uvReadErrorName(reader.error())), "syntax");
+
+    struct {
+        size_t UniValueReadLimits::*field;
+        size_t fits;
+        UniValueReadError err;
+    } cases[] = {
+        { &UniValueReadLimits::maxDepth, 3, READ_DEPTH },
+        { &UniValueReadLimits::maxNodes, 9, READ_NODES },
+        { &UniValueReadLimits::maxString, 200, READ_STRING },
+        { &UniValueReadLimits::maxMembers, 3, READ_MEMBERS },
+        { &UniValueReadLimits::maxSteps, 23, READ_STEPS },
+        { &UniValueReadLimits::maxBytes, expected.dynamicMemoryUsage(), READ_BYTES },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        // start from scratch, so that recycled capacity does not count
+        reader.release();
+        v = UniValue();
+
+        UniValueReadLimits limits;
+        limits.*cases[i].field = cases[i].fits;
+        reader.setLimits(limits);
+        BOOST_CHECK(reader.read(json, v));
+        BOOST_CHECK_EQUAL(v.write(), expected.write());
+
+        limits.*cases[i].field = cases[i].fits - 1;
+        reader.setLimits(limits);
+        reader.release();
+        v = UniValue();
+        BOOST_CHECK(!reader.read(json, v));
+        BOOST_CHECK_EQUAL(reader.error(), cases[i].err);
+        BOOST_CHECK(v.isNull());
+    }
+
+    // limits apply to keys and numbers as well as string values
+    UniValueReadLimits limits;
+    limits.maxString = 3;
+    reader.setLimits(limits);
+    BOOST_CHECK(reader.read("{\"abc\":123}", 11, v));
+    BOOST_CHECK(!reader.read("{\"abcd\":1}", 10, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_STRING);
+    BOOST_CHECK(!reader.read("[1234]", 6, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_STRING);
+    BOOST_CHECK(reader.read("\"\\u00e9x\"", 9, v));         // 3 bytes once unescaped
+
+    // a huge document is given up on early
+    std::string wide = "[";
+    for (int i = 0; i < 100000; i++)
+        wide += "0,";
+    wide += "0]";
+    limits = UniValueReadLimits();
+    limits.maxTime = std::chrono::nanoseconds(1);
+    reader.setLimits(limits);
+    BOOST_CHECK(!reader.read(wide, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_TIME);
+    limits = UniValueReadLimits();
+    limits.maxNodes = 1000;
+    reader.setLimits(limits);
+    size_t before = allocations;
+    BOOST_CHECK(!reader.read(wide, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_NODES);
+    BOOST_CHECK(allocations - before < 100);
+
+    // nothing after the document is tokenized, however long it is
+    std::string trailing = "{} \"" + std::string(1 << 20, 'x') + "\"";
+    limits = UniValueReadLimits();
+    limits.maxString = 3;
+    reader.setLimits(limits);
+    before = allocations;
+    BOOST_CHECK(!reader.read(trailing, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_SYNTAX);
+    BOOST_CHECK(allocations == before);
+
+    // the usage callback has its own code
+    reader.setLimits(UniValueReadLimits());
+    reader.setUsageCallback([](size_t usage) { return usage < 1000; });
+    BOOST_CHECK(!reader.read(json, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_ABORTED);
+    reader.setUsageCallback(UniValueUsageCallback());
+    BOOST_CHECK(reader.read(json, v));
+    BOOST_CHECK_EQUAL(reader.error(), READ_OK);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_exact_capacity)
+{
+    std::string json = "{\"hash\":\"" + std::string(64, 'a') + "\",\"tx\":[";
+    for (int i = 0; i < 50; i++) {
+        json += (i ? "," : "");
+        json += "{\"txid\":\"" + std::string(64, 'b') + "\",\"vin\":[{\"n\":0},{\"n\":1},{\"n\":2}],"
+                "\"vout\":[1.5,\"x,]}\\\"\",[],{}],\"size\":225}";
+    }
+    json += "],\"height\":800000}";
+
+    UniValue loose;
+    BOOST_CHECK(loose.read(json));
+    UniValue tight(loose);          // copies are allocated at exactly their size
+
+    UniValueReader reader;
+    reader.setExactCapacity(true);
+    UniValue exact;
+    BOOST_CHECK(reader.read(json, exact));      // warm up the scratch buffers
+    size_t before = allocations;
+    BOOST_CHECK(reader.read(json, exact));
+    size_t exactAllocs = allocations - before;
+    BOOST_CHECK_EQUAL(exact.write(), loose.write());
+    BOOST_CHECK_EQUAL(exact.dynamicMemoryUsage(), tight.dynamicMemoryUsage());
+    BOOST_CHECK(exact.dynamicMemoryUsage() < loose.dynamicMemoryUsage());
+
+    // no container is ever grown, so no more allocations than the copy
+    before = allocations;
+    UniValue copy(loose);
+    BOOST_CHECK(exactAllocs <= allocations - before);
+
+    // reading again, or reading something else, starts afresh
+    BOOST_CHECK(reader.read(json, exact));
+    BOOST_CHECK_EQUAL(exact.dynamicMemoryUsage(), tight.dynamicMemoryUsage());
+    const char *docs[] = { "[]", "{}", "[[],[1],{\"a\":[2,3]}]", "\"s\"", "[1,]", "{\"a\":1,}", "[\"]\"]" };
+    for (size_t i = 0; i < sizeof(docs) / sizeof(docs[0]); i++) {
+        UniValue ref;
+        bool ok = ref.read(docs[i]);
+        BOOST_CHECK_EQUAL(reader.read(docs[i], strlen(docs[i]), exact), ok);
+        BOOST_CHECK_EQUAL(exact.write(), ref.write());
+        BOOST_CHECK_EQUAL(exact.dynamicMemoryUsage(), UniValue(ref).dynamicMemoryUsage());
+    }
+
+    // compact() brings a built tree down to the same size
+    loose.compact();
+    BOOST_CHECK_EQUAL(loose.dynamicMemoryUsage(), tight.dynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(loose.write(), tight.write());
+    UniValue built(UniValue::VARR);
+    for (int i = 0; i < 100; i++)
+        BOOST_CHECK(built.push_back(std::string(i, 'z')));
+    size_t builtUsage = built.dynamicMemoryUsage();
+    built.compact();
+    BOOST_CHECK(built.dynamicMemoryUsage() < builtUsage);
+    BOOST_CHECK_EQUAL(built.dynamicMemoryUsage(), UniValue(built).dynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(built.size(), 100U);
+    BOOST_CHECK_EQUAL(built[99].get_str(), std::string(99, 'z'));
+}
+
+BOOST_AUTO_TEST_CASE(univalue_presize)
+{
+    // small containers are sized before they are filled: one allocation
+    // for the keys and one for the values, however many members
+    const char *obj = "{\"a\":1,\"b\":[true,false,null],\"c\":\"x\",\"d\":{},\"e\":5}";
+    UniValueReader reader;
+    UniValue warm, v;
+    BOOST_CHECK(reader.read(obj, strlen(obj), warm));   // size the parse stack
+    size_t before = allocations;
+    BOOST_CHECK(reader.read(obj, strlen(obj), v));
+    BOOST_CHECK_EQUAL(allocations - before, 3U);
+    BOOST_CHECK_EQUAL(v.size(), 5U);
+    BOOST_CHECK_EQUAL(v["b"].size(), 3U);
+
+    // members past the look-ahead window are still all read
+    std::string big = "[\"" + std::string(300, 's') + "\"";
+    for (int i = 0; i < 200; i++)
+        big += ",[" + std::to_string(i) + ",\"\\\"],\"]";
+    big += "]";
+    BOOST_CHECK(v.read(big));
+    BOOST_CHECK_EQUAL(v.size(), 201U);
+    BOOST_CHECK_EQUAL(v[200][0].get_int(), 199);
+    BOOST_CHECK_EQUAL(v[200][1].get_str(), "\"],");
+    BOOST_CHECK_EQUAL(v.write(), big);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_keytags)
+{
+    // lookups agree with a plain scan at every size around the 16-key
+    // blocks, including duplicate keys (the first one wins)
+    for (size_t n = 0; n < 70; n += 3) {
+        UniValue obj(UniValue::VOBJ);
+        for (size_t i = 0; i < n; i++)
+            obj.__pushKV("key" + std::to_string(i % 40), (int)i);
+        for (size_t i = 0; i < 45; i++) {
+            std::string k = "key" + std::to_string(i);
+            size_t expected = SIZE_MAX;
+            for (size_t j = 0; j < n && expected == SIZE_MAX; j++) {
+                if (obj.getKeys()[j] == k)
+                    expected = j;
+            }
+            BOOST_CHECK_EQUAL(obj.exists(k), expected != SIZE_MAX);
+            if (expected != SIZE_MAX) {
+                BOOST_CHECK_EQUAL(obj[k].get_int(), (int)expected);
+                BOOST_CHECK_EQUAL(&find_value(obj, k), &obj[k]);
+            } else {
+                BOOST_CHECK(obj[k].isNull());
+            }
+        }
+        BOOST_CHECK(!obj.exists(""));
+        BOOST_CHECK_EQUAL(obj.getValStr(), "");
+    }
+
+    // and however the object was made
+    std::string json = "{";
+    for (int i = 0; i < 40; i++)
+        json += (i ? ",\"" : "\"") + std::string(i, 'k') + "\":" + std::to_string(i);
+    json += "}";
+    UniValue parsed;
+    BOOST_CHECK(parsed.read(json));
+    UniValueReader reader;
+    reader.setExactCapacity(true);
+    UniValue exact;
+    BOOST_CHECK(reader.read(json, exact));
+    UniValue copy(exact);
+    BOOST_CHECK_EQUAL(exact.dynamicMemoryUsage(), copy.dynamicMemoryUsage());
+    UniValue obj(UniValue::VOBJ, "ignored");
+    BOOST_CHECK(obj.pushKVs(parsed));
+    for (int i = 0; i < 40; i++) {
+        std::string k(i, 'k');
+        BOOST_CHECK_EQUAL(parsed[k].get_int(), i);
+        BOOST_CHECK_EQUAL(exact[k].get_int(), i);
+        BOOST_CHECK_EQUAL(copy[k].get_int(), i);
+        BOOST_CHECK_EQUAL(obj[k].get_int(), i);
+    }
+    BOOST_CHECK(parsed["kkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkkk"].isNull());
+    obj.setArray();
+    BOOST_CHECK(!obj.exists(""));
+}
+
+struct BoundBlob {
+    std::vector<unsigned char> id;
+    std::vector<std::vector<unsigned char>> parts;
+    std::optional<std::vector<unsigned char>> extra;
+};
+
+template<> struct UniValueFields<BoundBlob> {
+    static constexpr auto fields = std::make_tuple(
+        UniValueField("id", &BoundBlob::id),
+        UniValueField("parts", &BoundBlob::parts),
+        UniValueField("extra", &BoundBlob::extra));
+};
+
+BOOST_AUTO_TEST_CASE(univalue_hex)
+{
+    // every length up to a few SIMD blocks, both ways
+    for (size_t n = 0; n < 70; n++) {
+        std::vector<uint8_t> bytes(n);
+        std::string text;
+        for (size_t i = 0; i < n; i++) {
+            bytes[i] = (uint8_t)(i * 37 + n);
+            static const char digits[] = "0123456789abcdef";
+            text += digits[bytes[i] >> 4];
+            text += digits[bytes[i] & 15];
+        }
+        UniValue v;
+        BOOST_CHECK(v.setHex(bytes.data(), bytes.size()));
+        BOOST_CHECK(v.isStr());
+        BOOST_CHECK_EQUAL(v.get_str(), text);
+        BOOST_CHECK_EQUAL(v.dynamicMemoryUsage(), UniValue(text).dynamicMemoryUsage());
+
+        std::vector<uint8_t> back(3, 0xff);
+        v.get_hex(back);
+        BOOST_CHECK(back == bytes);
+
+        // upper case decodes the same
+        std::string upper = text;
+        for (size_t i = 0; i < upper.size(); i++)
+            upper[i] = toupper(upper[i]);
+        UniValue(upper).get_hex(back);
+        BOOST_CHECK(back == bytes);
+
+        // any single bad digit is caught, wherever it falls in a block
+        for (size_t i = 0; i < text.size(); i += 7) {
+            const char bad[] = { 'g', 'G', '/', ':', '@', '`', ' ', '\x80' };
+            std::string broken = text;
+            broken[i] = bad[i % sizeof(bad)];
+            BOOST_CHECK_THROW(UniValue(broken).get_hex(back), std::runtime_error);
+        }
+    }
+
+    // every byte value
+    std::vector<uint8_t> all(256);
+    for (size_t i = 0; i < all.size(); i++)
+        all[i] = (uint8_t)i;
+    UniValue v;
+    v.setHex(all.data(), all.size());
+    BOOST_CHECK_EQUAL(v.get_str().substr(0, 8), "00010203");
+    BOOST_CHECK_EQUAL(v.get_str().substr(504), "fcfdfeff");
+    std::vector<uint8_t> back;
+    v.get_hex(back);
+    BOOST_CHECK(back == all);
+
+    BOOST_CHECK_THROW(UniValue("abc").get_hex(back), std::runtime_error);
+    BOOST_CHECK_THROW(UniValue(12).get_hex(back), std::runtime_error);
+    // a bad digit anywhere leaves the caller's vector untouched
+    BOOST_CHECK_THROW(UniValue("0102zz").get_hex(back), std::runtime_error);
+    BOOST_CHECK(back == all);
+
+    // the fixed-size form wants exactly the right length
+    uint8_t hash[4];
+    UniValue("deadBEEF").get_hex(hash, sizeof(hash));
+    BOOST_CHECK(hash[0] == 0xde && hash[3] == 0xef);
+    BOOST_CHECK_THROW(UniValue("deadbe").get_hex(hash, sizeof(hash)), std::runtime_error);
+    BOOST_CHECK_THROW(UniValue("deadbeef00").get_hex(hash, sizeof(hash)), std::runtime_error);
+
+    // SAX: a handler that asks for bytes gets hex strings without a std::string
+    class Bytes : public UniValueSAXHandler {
+    public:
+        std::vector<unsigned char> buf;
+        std::string out;
+        std::vector<unsigned char> *hexBuffer() override { return &buf; }
+        Action onHex(const std::vector<unsigned char>& bytes) override {
+            out += "x" + std::to_string(bytes.size());
+            return SAX_OK;
+        }
+        Action onString(const std::string& str) override { out += "'" + str; return SAX_OK; }
+        Action onKey(const std::string& key) override { out += "k" + key; return SAX_OK; }
+    };
+    Bytes b;
+    BOOST_CHECK(readJsonSAX("{\"00ff\":\"00FF\",\"b\":[\"\", \"abc\",\"a\\u0062\",\"zz\"]}", b));
+    BOOST_CHECK_EQUAL(b.out, "k00ffx2kbx0'abc'ab'zz");
+    b.out.clear();
+    BOOST_CHECK(readJsonSAX(" \"0102\" ", b));
+    BOOST_CHECK_EQUAL(b.out, "x2");
+    BOOST_CHECK(b.buf.size() == 2 && b.buf[1] == 2);
+    b.out.clear();
+    BOOST_CHECK(readJsonSAX("[\"0g12\",\"0a\\u0030\"]", b));         // not hex: buffer untouched
+    BOOST_CHECK_EQUAL(b.out, "'0g12'0a0");
+    BOOST_CHECK(b.buf.size() == 2 && b.buf[0] == 1 && b.buf[1] == 2);
+    BOOST_CHECK(!readJsonSAX("[\"00\" \"00\"]", b));
+    BOOST_CHECK(!readJsonSAX("\"00", b));
+
+    // bound binary members
+    BoundBlob blob;
+    decodeJSON("{\"id\":\"" + std::string(64, 'A') + "\",\"parts\":[\"01\",\"\",\"0\\u0030\"],"
+               "\"extra\":\"beef\"}", blob);
+    BOOST_CHECK_EQUAL(blob.id.size(), 32U);
+    BOOST_CHECK_EQUAL(blob.id[31], 0xaa);
+    BOOST_CHECK_EQUAL(blob.parts.size(), 3U);
+    BOOST_CHECK(blob.parts[0] == std::vector<unsigned char>(1, 1));
+    BOOST_CHECK(blob.parts[1].empty());
+    BOOST_CHECK(blob.parts[2] == std::vector<unsigned char>(1, 0));
+    BOOST_CHECK(blob.extra && blob.extra->size() == 2);
+    BOOST_CHECK_EQUAL(encodeJSON(blob),
+                      "{\"id\":\"" + std::string(64, 'a') + "\",\"parts\":[\"01\",\"\",\"00\"],"
+                      "\"extra\":\"beef\"}");
+    decodeJSON("{\"id\":\"\",\"parts\":[],\"extra\":null}", blob);
+    BOOST_CHECK(blob.id.empty() && blob.parts.empty() && !blob.extra);
+
+    const char *badBlobs[] = {
+        "{\"id\":\"0\",\"parts\":[]}", "{\"id\":\"0g\",\"parts\":[]}",
+        "{\"id\":1,\"parts\":[]}", "{\"parts\":[]}", "{\"id\":\"\",\"parts\":[\"x\"]}",
+    };
+    for (size_t i = 0; i < sizeof(badBlobs) / sizeof(badBlobs[0]); i++) {
+        try {
+            decodeJSON(badBlobs[i], blob);
+            BOOST_CHECK(false);
+        } catch (const std::runtime_error& e) {
+            BOOST_CHECK_EQUAL(std::string(e.what()), "JSON value is not a hex string as expected");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(univalue_counters)
+{
+    UniValueCounters::reset();
+    UniValue v;
+    BOOST_CHECK(v.read("{\"a\":[1,\"xy\",null],\"b\":true}"));
+    const UniValue& a = find_value(v, "a");
+    UniValue copy(a);
+    std::string text = v.write();
+    UniValueCounters c = UniValueCounters::threadSnapshot();
+
+    if (!UniValueCounters::enabled()) {
+        // compiled out: nothing is ever counted
+        BOOST_CHECK_EQUAL(c.bytesScanned, 0U);
+        BOOST_CHECK_EQUAL(c.copies, 0U);
+        BOOST_CHECK_EQUAL(UniValueCounters::snapshot().writeCalls, 0U);
+        return;
+    }
+
+    BOOST_CHECK_EQUAL(c.tokens[JTOK_OBJ_OPEN], 1U);
+    BOOST_CHECK_EQUAL(c.tokens[JTOK_STRING], 3U);
+    BOOST_CHECK_EQUAL(c.tokens[JTOK_COMMA], 3U);
+    BOOST_CHECK_EQUAL(c.tokens[JTOK_NONE], 1U);         // the check for trailing input
+    BOOST_CHECK_EQUAL(c.bytesScanned, 28U);
+    BOOST_CHECK_EQUAL(c.stringBytes, 10U);
+    BOOST_CHECK_EQUAL(c.nodes[UniValue::VOBJ], 1U);
+    BOOST_CHECK_EQUAL(c.nodes[UniValue::VARR], 1U);
+    BOOST_CHECK_EQUAL(c.nodes[UniValue::VNUM], 1U);
+    BOOST_CHECK_EQUAL(c.nodes[UniValue::VBOOL], 1U);
+    BOOST_CHECK_EQUAL(c.nodeBytes[UniValue::VNULL], 0U);
+    BOOST_CHECK(c.nodeBytes[UniValue::VARR] > 0);
+    BOOST_CHECK_EQUAL(c.findKeyCalls, 1U);
+    BOOST_CHECK_EQUAL(c.findKeyProbes, 1U);
+    BOOST_CHECK(c.copies >= 1);
+    BOOST_CHECK(c.copyBytes >= a.dynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(c.writeCalls, 1U);
+    BOOST_CHECK_EQUAL(c.writeBytes, text.size());
+    BOOST_CHECK_EQUAL(c.writeGrowth, 0U);
+
+    UniValue big(UniValue::VARR);
+    big.push_back(std::string(3000, 'x'));
+    UniValueCounters::reset();
+    big.write();
+    BOOST_CHECK_EQUAL(UniValueCounters::threadSnapshot().writeGrowth, 1U);
+
+    // other threads' counts show up in the total, even after they exit
+    UniValueCounters::reset();
+    std::thread t([]() {
+        UniValue w;
+        w.read("[1,2]");
+    });
+    t.join();
+    BOOST_CHECK_EQUAL(UniValueCounters::threadSnapshot().nodes[UniValue::VNUM], 0U);
+    BOOST_CHECK_EQUAL(UniValueCounters::snapshot().nodes[UniValue::VNUM], 2U);
+    UniValueCounters::reset();
+    BOOST_CHECK_EQUAL(UniValueCounters::snapshot().nodes[UniValue::VNUM], 0U);
+}
+
+BOOST_AUTO_TEST_CASE(univalue_cpu_tiers)
+{
+    // Everything the kernels are used for, as one transcript to compare
+    // between tiers
+    struct Transcript {
+        static std::string of()
+        {
+            std::string out;
+            UniValueReader exact;
+            exact.setExactCapacity(true);
+
+            // one odd byte at every offset of strings up to a few blocks
+            const char *odd[] = { "\"", "\\", "\n", "\x1f", "\x7f", "\xc3\xa9", "\x80",
+                                  "\xe2\x82", "[", "}", ",", " " };
+            for (size_t n = 0; n < 140; n += (n < 70 ? 1 : 13)) {
+                for (size_t o = 0; o < sizeof(odd) / sizeof(odd[0]); o++) {
+                    for (size_t at = 0; at <= n; at += (n < 20 ? 1 : 7)) {
+                        std::string s(n, 'a');
+                        s.insert(at, odd[o]);
+                        std::string text = UniValue(s).write();
+                        out += text + UniValue(s).writeCBOR();
+
+                        UniValue back;
+                        std::string doc = "[" + text + ",{" + text + ":[" + text + "]}]";
+                        out += back.read(doc) ? back.write() : "!";
+                        out += std::to_string(back.dynamicMemoryUsage());
+                        out += exact.read(doc, back) ? "e" : "!";
+                        out += std::to_string(back.dynamicMemoryUsage());
+
+                        // and unescaped, where that is not valid JSON
+                        out += back.read("\"" + s + "\"") ? back.get_str() : "!";
+                    }
+                }
+            }
+
+            // hex both ways, with and without a bad digit
+            for (size_t n = 0; n < 200; n += (n < 70 ? 1 : 9)) {
+                std::vector<uint8_t> bytes(n);
+                for (size_t i = 0; i < n; i++)
+                    bytes[i] = (uint8_t)(i * 151 + n);
+                UniValue v;
+                v.setHex(bytes.data(), bytes.size());
+                out += v.get_str();
+                std::vector<uint8_t> back;
+                v.get_hex(back);
+                out += back == bytes ? "=" : "!";
+                for (size_t i = 0; i < 2 * n; i += 5) {
+                    std::string broken = v.get_str();
+                    broken[i] = "gG/:@` "[i % 7];
+                    try {
+                        UniValue(broken).get_hex(back);
+                        out += "!";
+                    } catch (const std::runtime_error&) {
+                        out += "x";
+                    }
+                }
+            }
+
+            // lookups in objects wide enough for the tag scan
+            for (size_t n = 0; n < 150; n += 7) {
+                UniValue obj(UniValue::VOBJ);
+                for (size_t i = 0; i < n; i++)
+                    obj.pushKV("key" + std::to_string(i * 3), (int64_t)i);
+                for (size_t i = 0; i < 3 * n + 3; i++) {
+                    const UniValue& found = find_value(obj, "key" + std::to_string(i));
+                    out += found.isNull() ? "-" : found.getValStr();
+                }
+            }
+            return out;
+        }
+    };
+
+    const UniValueCPUTier start = uvCPUTier();
+    BOOST_CHECK(uvCPUSupports(CPU_SCALAR));
+    BOOST_CHECK(uvCPUSupports(uvCPUBestTier()));
+    if (!getenv("UNIVALUE_CPU"))
+        BOOST_CHECK_EQUAL(start, uvCPUBestTier());
+
+    BOOST_CHECK(uvSetCPUTier(CPU_SCALAR));
+    BOOST_CHECK_EQUAL(uvCPUTier(), CPU_SCALAR);
+    const std::string expected = Transcript::of();
+
+    const UniValueCPUTier tiers[] = { CPU_SCALAR, CPU_SSE2, CPU_SSE42, CPU_AVX2,
+                                      CPU_AVX512, CPU_NEON };
+    for (size_t t = 0; t < sizeof(tiers) / sizeof(tiers[0]); t++) {
+        UniValueCPUTier tier = tiers[t];
+        UniValueCPUTier named;
+        BOOST_CHECK(uvCPUTierFromName(uvCPUTierName(tier), named));
+        BOOST_CHECK_EQUAL(named, tier);
+
+        if (!uvSetCPUTier(tier)) {
+            // an unsupported tier changes nothing
+            BOOST_CHECK(!uvCPUSupports(tier));
+            continue;
+        }
+        BOOST_CHECK_EQUAL(uvCPUTier(), tier);
+        BOOST_CHECK(Transcript::of() == expected);
+    }
+
+    UniValueCPUTier named;
+    BOOST_CHECK(!uvCPUTierFromName("mmx", named));
+    BOOST_CHECK(uvSetCPUTier(start));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 int main (int argc, char *argv[])
@@ -408,6 +2216,29 @@ int main (int argc, char *argv[])
     univalue_array();
     univalue_object();
     univalue_readwrite();
+    univalue_writeparallel();
+    univalue_streamwriter();
+    univalue_cbor();
+    univalue_msgpack();
+    univalue_snapshot();
+    univalue_path();
+    univalue_keyviews();
+    univalue_sax();
+    univalue_schema();
+    univalue_bind();
+    univalue_encode();
+    univalue_jsonpath();
+    univalue_freeze();
+    univalue_batch();
+    univalue_reader();
+    univalue_memusage();
+    univalue_read_limits();
+    univalue_exact_capacity();
+    univalue_presize();
+    univalue_keytags();
+    univalue_hex();
+    univalue_counters();
+    univalue_cpu_tiers();
     return 0;
 }
 
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <string>
 #include "univalue.h"
+#include "univalue_sax.h"
 
 #ifndef JSON_TEST_SRC
 #error JSON_TEST_SRC must point to test source directory
@@ -47,10 +48,23 @@ static void runtest(std::string filename, const std::string& jdata)
             d_assert(testResult == false);
         }
 
+        UniValueSAXHandler saxHandler;
+        d_assert(readJsonSAX(jdata, saxHandler) == testResult);
+
         if (wantRoundTrip) {
             std::string odata = val.write(0, 0);
             assert(odata == rtrim(jdata));
         }
+
+        if (testResult) {
+            UniValue cborVal;
+            d_assert(cborVal.readCBOR(val.writeCBOR()));
+            d_assert(cborVal.write() == val.write());
+
+            UniValue msgpackVal;
+            d_assert(msgpackVal.readMsgPack(val.writeMsgPack()));
+            d_assert(msgpackVal.write() == val.write());
+        }
 }
 
 static void runtest_file(const char *filename_)
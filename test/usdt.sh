@@ -0,0 +1,27 @@
+#!/bin/sh
+# Copyright 2026 UniValue Developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or https://opensource.org/licenses/mit-license.php.
+#
+# Check that a library built with ./configure --enable-usdt has every
+# tracepoint that contrib/univalue.bt attaches to.
+
+PROBES="read__start read__done write__start write__done sax__start sax__done"
+
+lib=.libs/libunivalue.so
+test -f "$lib" || lib=.libs/libunivalue.a
+if test ! -f "$lib"; then
+    echo "usdt.sh: no library built in $(pwd)"
+    exit 99
+fi
+
+notes=$(${READELF:-readelf} -n "$lib") || exit 99
+
+status=0
+for probe in $PROBES; do
+    if ! printf '%s\n' "$notes" | grep -A1 'Provider: univalue$' | grep -q "Name: $probe\$"; then
+        echo "missing probe univalue:$probe in $lib"
+        status=1
+    fi
+done
+exit $status